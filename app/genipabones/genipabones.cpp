@@ -9,8 +9,6 @@
 #include <string.h>
 #include <ctype.h>
 #include <vector>
-#include <signal.h>
-#include <unistd.h>
 
 using namespace std;
 
@@ -90,16 +88,6 @@ bool loadFormula(void* solver, const char* filename, vector<int>& boundary, int&
 	return true;
 }
 
-int terminateFlag = 0;
-
-int terminateCallback(void * state) {
-	return terminateFlag;
-}
-
-void watchdog(int sig) {
-	terminateFlag = 1;
-}
-
 int main(int argc, char **argv) {
 	printf("c This program finds back-bones of a CNF SAT formula. A back-bone is assignment fixed in all solutions.\n");
 	printf("c You can specify backbone candidates by adding a line starting with 'cvip' followed by variables names separated by space to the cnf file.\n");
@@ -132,12 +120,16 @@ int main(int argc, char **argv) {
 		printf("c Will check %lu candidates for backbones.\n", boundary.size());
 	}
 
-	int timelimit = 0;
+	// fractions of seconds are allowed, the limit is passed on in milliseconds,
+	// a limit of zero or less means no limit like 'alarm(0)' did before
+	long long timelimit = -1;
 	if ((argc > 2 && argv[2][1] == 't')) {
-		timelimit = atoi(argv[2]+3);
-		printf("c Time limit per check is %d seconds\n", timelimit);
-		ipasir_set_terminate(solver, NULL, terminateCallback);
-		signal(SIGALRM, watchdog);
+		timelimit = (long long)(atof(argv[2]+3) * 1000);
+		if (timelimit <= 0) {
+			timelimit = -1;
+		} else {
+			printf("c Time limit per check is %lld milliseconds\n", timelimit);
+		}
 	}
 
 	int bbonesFound = 0;
@@ -147,26 +139,22 @@ int main(int argc, char **argv) {
 		printf("c Checking canidate %d, (nr. %lu of %lu)\n", candidate, i+1, boundary.size());
 		// check positive case
 		ipasir_assume(solver, candidate);
-		terminateFlag = 0;
-		alarm(timelimit);
+		ipasir_set_limits(solver, -1, -1, timelimit);
 		int res = ipasir_solve(solver);
 		if (res == 20) {
 			bbonesFound++;
 			printf("%d 0\n", -candidate);
 			continue;
 		}
-		alarm(0);
 
 		// check negative case
 		ipasir_assume(solver, -candidate);
-		terminateFlag = 0;
-		alarm(timelimit);
+		ipasir_set_limits(solver, -1, -1, timelimit);
 		res = ipasir_solve(solver);
 		if (res == 20) {
 			bbonesFound++;
 			printf("%d 0\n", candidate);
 		}
-		alarm(0);
 	}
 
 	printf("c Found %d backbones\n", bbonesFound);
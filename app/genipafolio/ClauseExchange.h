@@ -0,0 +1,148 @@
+/*
+ * ClauseExchange.h
+ *
+ * A bounded lock-free buffer for exchanging short learned clauses
+ * between the solver threads of the portfolio.
+ */
+
+#ifndef CLAUSEEXCHANGE_H_
+#define CLAUSEEXCHANGE_H_
+
+#include <stdint.h>
+#include <string.h>
+
+// Maximal length of exchanged clauses, longer ones are not exported.
+// The ipasir interface does not tell us the LBD of learned clauses,
+// so the length is the only quality filter we have.
+#define EXCHANGE_MAX_LENGTH 8
+// Number of clauses in the ring buffer, has to be a power of two.
+#define EXCHANGE_SLOTS (1 << 14)
+// Number of remembered clause hashes used to suppress duplicates,
+// has to be a power of two.
+#define EXCHANGE_HASHES (1 << 16)
+
+// One exported clause.  The sequence number works like a seqlock, it is
+// odd while the clause is written and '2*ticket+2' once the clause with
+// the given ticket is published.
+struct ExchangeSlot {
+	uint64_t seq;
+	int producer;
+	int size;
+	int lits[EXCHANGE_MAX_LENGTH];
+};
+
+// The exchange does not allocate memory and does not contain pointers,
+// i.e., a zero initialized object is ready to use, even when placed into
+// memory shared by several processes.
+//
+// Producers never wait, they get a ticket which determines the slot and
+// overwrite older clauses.  Consumers have their own cursor (the next
+// ticket to read) and lose clauses if they fall more than EXCHANGE_SLOTS
+// clauses behind.  Publishing may also fail if another producer still
+// writes into the same slot, the exchange is lossy in any case.
+struct ClauseExchange {
+	uint64_t head;
+	uint64_t hashes[EXCHANGE_HASHES];
+	ExchangeSlot slots[EXCHANGE_SLOTS];
+
+	void init() {
+		memset(this, 0, sizeof(ClauseExchange));
+	}
+
+	static uint64_t hashLiteral(int lit) {
+		uint64_t x = (uint64_t)(int64_t)lit * 0x9E3779B97F4A7C15ull;
+		x ^= x >> 29;
+		x *= 0xBF58476D1CE4E5B9ull;
+		return x ^ (x >> 32);
+	}
+
+	// the hash does not depend on the order of the literals
+	static uint64_t hashClause(const int* clause, int size) {
+		uint64_t sum = 0, xored = 0;
+		for (int i = 0; i < size; i++) {
+			uint64_t h = hashLiteral(clause[i]);
+			sum += h;
+			xored ^= h;
+		}
+		return (sum ^ (xored * 0x94D049BB133111EBull)) | 1;
+	}
+
+	// Publish a zero terminated clause, return false if it has been
+	// dropped because it is too long or has been seen recently.
+	bool publish(int producer, const int* clause) {
+		int size = 0;
+		while (clause[size] != 0) {
+			if (++size > EXCHANGE_MAX_LENGTH) {
+				return false;
+			}
+		}
+		uint64_t hash = hashClause(clause, size);
+		uint64_t* seen = &hashes[hash & (EXCHANGE_HASHES - 1)];
+		if (__atomic_load_n(seen, __ATOMIC_RELAXED) == hash) {
+			return false;
+		}
+		__atomic_store_n(seen, hash, __ATOMIC_RELAXED);
+
+		uint64_t ticket = __atomic_fetch_add(&head, 1, __ATOMIC_RELAXED);
+		ExchangeSlot& slot = slots[ticket & (EXCHANGE_SLOTS - 1)];
+		uint64_t old = __atomic_load_n(&slot.seq, __ATOMIC_RELAXED);
+		// only take over a slot which is not being written and not
+		// already used by a newer ticket
+		if ((old & 1) || old > 2*ticket ||
+			!__atomic_compare_exchange_n(&slot.seq, &old, 2*ticket + 1,
+				false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+			return false;
+		}
+		__atomic_store_n(&slot.producer, producer, __ATOMIC_RELAXED);
+		__atomic_store_n(&slot.size, size, __ATOMIC_RELAXED);
+		for (int i = 0; i < size; i++) {
+			__atomic_store_n(&slot.lits[i], clause[i], __ATOMIC_RELAXED);
+		}
+		__atomic_store_n(&slot.seq, 2*ticket + 2, __ATOMIC_RELEASE);
+		return true;
+	}
+
+	// Read the next clause of another producer after 'cursor' into
+	// 'clause' (zero terminated, EXCHANGE_MAX_LENGTH+1 entries) and
+	// advance the cursor.  Return false if there is no such clause yet.
+	bool consume(int consumer, uint64_t& cursor, int* clause) {
+		uint64_t end = __atomic_load_n(&head, __ATOMIC_RELAXED);
+		if (end - cursor > EXCHANGE_SLOTS) {
+			cursor = end - EXCHANGE_SLOTS;
+		}
+		for (; cursor < end; cursor++) {
+			ExchangeSlot& slot = slots[cursor & (EXCHANGE_SLOTS - 1)];
+			uint64_t seq = __atomic_load_n(&slot.seq, __ATOMIC_ACQUIRE);
+			if (seq == 2*cursor + 1) {
+				// still being written, try again next time
+				return false;
+			}
+			if (seq != 2*cursor + 2) {
+				// overwritten or dropped
+				continue;
+			}
+			int producer = __atomic_load_n(&slot.producer, __ATOMIC_RELAXED);
+			int size = __atomic_load_n(&slot.size, __ATOMIC_RELAXED);
+			if (size < 0 || size > EXCHANGE_MAX_LENGTH) {
+				continue;
+			}
+			for (int i = 0; i < size; i++) {
+				clause[i] = __atomic_load_n(&slot.lits[i], __ATOMIC_RELAXED);
+			}
+			clause[size] = 0;
+			__atomic_thread_fence(__ATOMIC_ACQUIRE);
+			if (__atomic_load_n(&slot.seq, __ATOMIC_RELAXED) != seq) {
+				// overwritten while reading
+				continue;
+			}
+			if (producer == consumer) {
+				continue;
+			}
+			cursor++;
+			return true;
+		}
+		return false;
+	}
+};
+
+#endif /* CLAUSEEXCHANGE_H_ */
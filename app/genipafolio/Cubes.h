@@ -0,0 +1,86 @@
+/*
+ * Cubes.h
+ *
+ * The work queue of the cube-and-conquer mode.  A cube assigns each of
+ * the (at most 31) split variables and is stored as a bit mask, where bit
+ * j is set if the j-th split variable is assigned false.
+ */
+
+#ifndef CUBES_H_
+#define CUBES_H_
+
+#include "Threading.h"
+#include <deque>
+#include <vector>
+
+class CubeQueue {
+private:
+	// Each worker takes cubes from the back of its own queue and steals
+	// from the front of the other queues when its own one is empty.
+	int workers;
+	std::deque<unsigned>* queues;
+	Mutex* locks;
+	// Refuted parts of the search space, a cube is refuted if it agrees
+	// with 'values' on the split variables in 'mask'.
+	std::vector<unsigned> masks, values;
+	Mutex refutedLock;
+
+public:
+	CubeQueue(int workers, int splitVariables) : workers(workers) {
+		queues = new std::deque<unsigned>[workers];
+		locks = new Mutex[workers];
+		unsigned cubes = 1u << splitVariables;
+		for (unsigned cube = 0; cube < cubes; cube++) {
+			queues[cube % workers].push_back(cube);
+		}
+	}
+	virtual ~CubeQueue() {
+		delete[] queues;
+		delete[] locks;
+	}
+
+	// Get the next cube for the given worker, return false if there are
+	// no cubes left at all.
+	bool next(int worker, unsigned& cube) {
+		for (int i = 0; i < workers; i++) {
+			int other = (worker + i) % workers;
+			locks[other].lock();
+			bool found = !queues[other].empty();
+			if (found && other == worker) {
+				cube = queues[other].back();
+				queues[other].pop_back();
+			} else if (found) {
+				cube = queues[other].front();
+				queues[other].pop_front();
+			}
+			locks[other].unlock();
+			if (found) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Record that all the cubes agreeing with 'value' on 'mask' are
+	// unsatisfiable, e.g., because the failed assumptions of an
+	// unsatisfiable cube only contained the split variables in 'mask'.
+	void refute(unsigned mask, unsigned value) {
+		refutedLock.lock();
+		masks.push_back(mask);
+		values.push_back(value);
+		refutedLock.unlock();
+	}
+
+	// Check if a cube is covered by an already refuted one.
+	bool refuted(unsigned cube) {
+		refutedLock.lock();
+		bool res = false;
+		for (size_t i = 0; i < masks.size() && !res; i++) {
+			res = (cube & masks[i]) == values[i];
+		}
+		refutedLock.unlock();
+		return res;
+	}
+};
+
+#endif /* CUBES_H_ */
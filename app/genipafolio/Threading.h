@@ -9,8 +9,10 @@
 #define THREADING_H_
 
 #include <pthread.h>
+#include <sched.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <vector>
 
 #define TESTRUN(cmd, msg) int res = cmd; if (res != 0) { printf(msg,res); exit(res); }
 
@@ -36,6 +38,58 @@ public:
 	}
 };
 
+// A condition variable together with its mutex.  The 'wait', 'signal'
+// and 'broadcast' methods have to be called while holding the lock.
+class Condition {
+private:
+	pthread_mutex_t mtx;
+	pthread_cond_t cond;
+public:
+	Condition() {
+		{ TESTRUN(pthread_mutex_init(&mtx, NULL), "Mutex init failed with msg %d\n") }
+		{ TESTRUN(pthread_cond_init(&cond, NULL), "Condition init failed with msg %d\n") }
+	}
+	virtual ~Condition() {
+		{ TESTRUN(pthread_cond_destroy(&cond), "Condition destroy failed with msg %d\n") }
+		{ TESTRUN(pthread_mutex_destroy(&mtx), "Mutex destroy failed with msg %d\n") }
+	}
+	void lock() {
+		TESTRUN(pthread_mutex_lock(&mtx), "Mutex lock failed with msg %d\n")
+	}
+	void unlock() {
+		TESTRUN(pthread_mutex_unlock(&mtx), "Mutex unlock failed with msg %d\n")
+	}
+	void wait() {
+		TESTRUN(pthread_cond_wait(&cond, &mtx), "Condition wait failed with msg %d\n")
+	}
+	void signal() {
+		TESTRUN(pthread_cond_signal(&cond), "Condition signal failed with msg %d\n")
+	}
+	void broadcast() {
+		TESTRUN(pthread_cond_broadcast(&cond), "Condition broadcast failed with msg %d\n")
+	}
+};
+
+// All the threads calling 'wait' block until 'count' of them arrived.
+class Barrier {
+private:
+	pthread_barrier_t barrier;
+public:
+	Barrier(int count) {
+		TESTRUN(pthread_barrier_init(&barrier, NULL, count), "Barrier init failed with msg %d\n")
+	}
+	virtual ~Barrier() {
+		TESTRUN(pthread_barrier_destroy(&barrier), "Barrier destroy failed with msg %d\n")
+	}
+	void wait() {
+		int res = pthread_barrier_wait(&barrier);
+		if (res != 0 && res != PTHREAD_BARRIER_SERIAL_THREAD) {
+			printf("Barrier wait failed with msg %d\n", res);
+			exit(res);
+		}
+	}
+};
+
 class Thread {
 private:
 	pthread_t thread;
@@ -43,11 +97,104 @@ public:
 	Thread(void*(*method)(void*), void* arg) {
 		pthread_create(&thread, NULL, method, arg);
 	}
+	// Start the thread pinned to the given cpu (if non-negative).  Memory
+	// first touched by the thread is then allocated on the NUMA node of
+	// that cpu by the default Linux policy.
+	Thread(void*(*method)(void*), void* arg, int cpu) {
+		pthread_attr_t attr;
+		pthread_attr_init(&attr);
+#ifdef __linux__
+		if (cpu >= 0) {
+			cpu_set_t set;
+			CPU_ZERO(&set);
+			CPU_SET(cpu, &set);
+			pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+		}
+#endif
+		pthread_create(&thread, &attr, method, arg);
+		pthread_attr_destroy(&attr);
+	}
 	void join() {
 		pthread_join(thread, NULL);
 	}
 };
 
+// Read a single number from a sysfs file, return -1 on failure.
+static int readTopology(int cpu, const char* name) {
+	char path[128];
+	snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/%s", cpu, name);
+	FILE* f = fopen(path, "r");
+	if (f == NULL) {
+		return -1;
+	}
+	int res = -1;
+	if (fscanf(f, "%d", &res) != 1) {
+		res = -1;
+	}
+	fclose(f);
+	return res;
+}
 
+// Return the cpus (allowed for this process) in the order in which threads
+// should be pinned to them.  First one cpu of each physical core, with the
+// sockets taking turns, such that the threads are spread over all sockets
+// and their memory controllers.  Then, if 'siblings' is true, the remaining
+// hyper-threads in the same order.  Returns an empty vector if the cpus
+// cannot be determined.
+static std::vector<int> cpuPlacement(bool siblings) {
+	std::vector<int> res;
+#ifdef __linux__
+	cpu_set_t allowed;
+	if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+		return res;
+	}
+	// cores[package] lists the first cpu of each core in that package,
+	// threads[package] the other cpus
+	std::vector<std::vector<int> > cores, threads;
+	std::vector<std::pair<int, int> > seen;
+	for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+		if (!CPU_ISSET(cpu, &allowed)) {
+			continue;
+		}
+		int package = readTopology(cpu, "physical_package_id");
+		int core = readTopology(cpu, "core_id");
+		if (package < 0) {
+			package = 0;
+		}
+		if (core < 0) {
+			core = cpu;
+		}
+		if ((int)cores.size() <= package) {
+			cores.resize(package + 1);
+			threads.resize(package + 1);
+		}
+		bool sibling = false;
+		for (size_t i = 0; i < seen.size(); i++) {
+			if (seen[i].first == package && seen[i].second == core) {
+				sibling = true;
+			}
+		}
+		if (sibling) {
+			threads[package].push_back(cpu);
+		} else {
+			seen.push_back(std::make_pair(package, core));
+			cores[package].push_back(cpu);
+		}
+	}
+	for (int pass = 0; pass < (siblings ? 2 : 1); pass++) {
+		std::vector<std::vector<int> >& cpus = pass == 0 ? cores : threads;
+		for (size_t i = 0, added = 1; added; i++) {
+			added = 0;
+			for (size_t p = 0; p < cpus.size(); p++) {
+				if (i < cpus[p].size()) {
+					res.push_back(cpus[p][i]);
+					added++;
+				}
+			}
+		}
+	}
+#endif
+	return res;
+}
 
 #endif /* THREADING_H_ */
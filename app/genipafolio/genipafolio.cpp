@@ -2,10 +2,14 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <unistd.h>
 #include "Threading.h"
+#include "ClauseExchange.h"
+#include "Cubes.h"
 #include <algorithm>
 #include <vector>
 #include <ctype.h>
+#include <math.h>
 
 // The linked SAT solver might be written in C
 // while this application is written in C++
@@ -15,16 +19,24 @@ extern "C" {
 
 using namespace std;
 
+// The clauses of the formula in one flat array, each of them terminated
+// by a zero, and the position of each clause in that array.  It is filled
+// once and then only read by the solver threads.
+struct Formula {
+	vector<int> literals;
+	vector<size_t> starts;
+};
+
 // Parse a dimacs cnf formula from a given file and
-// save its clauses into a given vector.
-bool loadFormula(vector<vector<int> >& clauses, const char* filename) {
+// save its clauses into a given formula.
+bool loadFormula(Formula& formula, const char* filename) {
 	FILE* f = fopen(filename, "r");
 	if (f == NULL) {
 		return false;
 	}
 	int c = 0;
 	bool neg = false;
-	vector<int> cls;
+	size_t start = 0;
 	while (c != EOF) {
 		c = fgetc(f);
 		// comment or problem definition line
@@ -56,11 +68,10 @@ bool loadFormula(vector<vector<int> >& clauses, const char* filename) {
 				num *= -1;
 			}
 			neg = false;
-			if (num != 0) {
-				cls.push_back(num);
-			} else {
-				clauses.push_back(vector<int>(cls));
-				cls.clear();
+			formula.literals.push_back(num);
+			if (num == 0) {
+				formula.starts.push_back(start);
+				start = formula.literals.size();
 			}
 		}
 	}
@@ -70,74 +81,444 @@ bool loadFormula(vector<vector<int> >& clauses, const char* filename) {
 
 // This global variable is used to store the result of the solving
 // and also to signal that all the SAT solving threads can stop.
+// It is only accessed atomically since all the threads poll it.
 int result = 0;
 
+// The main thread waits on this condition until a solver found the result
+// or all of them stopped.  The number of stopped solvers and the id of
+// the solver which found the result are protected by it.
+Condition done;
+int stopped = 0;
+int winner = -1;
+
 // This function is called by the SAT solvers from different threads
 // to determine if they should abort solving of the formula.
 // A non-zero value indicates that the solver should abort (in accordance with
 // the ipasir definition).
 int terminator(void* state) {
-	return result;
+	return __atomic_load_n(&result, __ATOMIC_RELAXED);
 }
 
-// Each thread is running this function which runs ipasir_solve
-void* solverThread(void* solver) {
-	int res = ipasir_solve(solver);
-	printf("c [genipafolio] solver stopped, res = %d\n", res);
-	if (res != 0) {
-		result = res;
+// The solvers share their short learned clauses through this exchange.
+ClauseExchange exchange;
+
+// Each solver has its own read position in the exchange and a buffer
+// for the clause which it currently imports.
+struct SharingState {
+	int id;
+	uint64_t cursor;
+	int clause[EXCHANGE_MAX_LENGTH + 1];
+};
+
+// Called by each solver for its learned clauses up to EXCHANGE_MAX_LENGTH.
+void exporter(void* state, int* clause) {
+	exchange.publish(((SharingState*)state)->id, clause);
+}
+
+// Called by each solver to get the clauses learned by the other solvers.
+const int* importer(void* state) {
+	SharingState* s = (SharingState*)state;
+	return exchange.consume(s->id, s->cursor, s->clause) ? s->clause : NULL;
+}
+
+// In deterministic mode the solvers run in epochs of a given number of
+// conflicts.  The clauses learned during an epoch are collected by each
+// worker and only handed to the other workers at the barrier between two
+// epochs, in the order of the worker ids.  The barrier is entered from the
+// terminate callback, so ipasir_solve is called only once and the solvers
+// keep their restart and clause database limits across epochs.
+Barrier* epochBarrier = NULL;
+int epochConflicts = 0;
+
+struct EpochState {
+	// learned clauses of the current epoch, each terminated by a zero
+	vector<int> learned;
+	// clauses of the other workers to import and the next one to import
+	vector<int> pending;
+	size_t position;
+	// polls of the terminate callback in the current epoch
+	int polls;
+	// result of the solver and the id of the first worker with a result
+	int result;
+	int first;
+
+	EpochState() : position(0), polls(0), result(0), first(-1) {
 	}
-	return NULL;
+};
+
+// Called by each solver for its learned clauses up to EXCHANGE_MAX_LENGTH.
+void collector(void* state, int* clause) {
+	vector<int>& learned = ((EpochState*)state)->learned;
+	do {
+		learned.push_back(*clause);
+	} while (*clause++ != 0);
 }
 
-// Returns a random number between 0 and Max
-int randGen(int Max) {
-	return rand() % Max;
+// Called by each solver to get the clauses of the other workers.
+const int* epochImporter(void* state) {
+	EpochState* s = (EpochState*)state;
+	if (s->position >= s->pending.size()) {
+		return NULL;
+	}
+	const int* res = &s->pending[s->position];
+	while (s->pending[s->position++] != 0);
+	return res;
+}
+
+// Pick the 'count' most constrained variables of the formula for
+// splitting, in the spirit of lookahead solvers: each occurrence of a
+// literal is weighted by 2^-(clause length) and variables with many short
+// clauses in both polarities are preferred.
+vector<int> splitVariables(const Formula& fla, int count) {
+	vector<double> pos, neg;
+	for (size_t i = 0; i < fla.starts.size(); i++) {
+		const int* cls = &fla.literals[fla.starts[i]];
+		int size = 0;
+		while (cls[size] != 0) {
+			size++;
+		}
+		double weight = ldexp(1.0, -size);
+		for (int j = 0; j < size; j++) {
+			size_t var = abs(cls[j]);
+			if (var >= pos.size()) {
+				pos.resize(var + 1, 0);
+				neg.resize(var + 1, 0);
+			}
+			if (cls[j] > 0) {
+				pos[var] += weight;
+			} else {
+				neg[var] += weight;
+			}
+		}
+	}
+	vector<pair<double, int> > scores;
+	for (size_t var = 1; var < pos.size(); var++) {
+		if (pos[var] + neg[var] > 0) {
+			scores.push_back(make_pair(1024*pos[var]*neg[var] + pos[var] + neg[var], (int)var));
+		}
+	}
+	count = min(count, (int)scores.size());
+	partial_sort(scores.begin(), scores.begin() + count, scores.end(), greater<pair<double, int> >());
+	vector<int> res;
+	for (int i = 0; i < count; i++) {
+		res.push_back(scores[i].second);
+	}
+	return res;
+}
+
+// Everything a solver thread needs, the formula is shared by all of them.
+// In cube-and-conquer mode 'cubes' is shared as well, otherwise it is NULL.
+struct Worker {
+	int id;
+	const Formula* formula;
+	void* solver;
+	SharingState sharing;
+	CubeQueue* cubes;
+	const vector<int>* split;
+	// the other workers and the own state for deterministic mode
+	Worker* all;
+	int count;
+	EpochState* epoch;
+};
+
+// Wait for the other workers at the end of an epoch.  If one of them has
+// a result, the one with the smallest id is recorded as the first one and
+// all of them stop, otherwise they get the clauses learned by the others.
+// Clauses from the previous epoch not imported yet are dropped, solvers
+// which cannot import clauses would accumulate them otherwise.
+void nextEpoch(Worker* worker) {
+	EpochState& epoch = *worker->epoch;
+	epochBarrier->wait();
+	for (int i = 0; i < worker->count; i++) {
+		if (worker->all[i].epoch->result != 0) {
+			epoch.first = i;
+			return;
+		}
+	}
+	epoch.pending.clear();
+	epoch.position = 0;
+	for (int i = 0; i < worker->count; i++) {
+		if (i != worker->id) {
+			const vector<int>& learned = worker->all[i].epoch->learned;
+			epoch.pending.insert(epoch.pending.end(), learned.begin(), learned.end());
+		}
+	}
+	epochBarrier->wait();
+	epoch.learned.clear();
+	epoch.polls = 0;
+}
+
+// The terminate callback of deterministic mode.  With 'term_period' set
+// to one MiniSat polls it once per conflict, other solvers poll it at
+// their own deterministic points, e.g., picosat every 1024 decisions.
+int epochTerminator(void* state) {
+	Worker* worker = (Worker*)state;
+	EpochState& epoch = *worker->epoch;
+	if (epoch.first < 0 && ++epoch.polls >= epochConflicts) {
+		nextEpoch(worker);
+	}
+	return epoch.first >= 0;
+}
+
+// Run the solver in epochs until one of the solvers has a result.  All
+// the workers see the same results after each epoch and the one with the
+// smallest id wins, so the run only depends on the number of workers.
+// The remaining overhead is waiting at the barriers for the slowest
+// solver of each epoch and that MiniSat imports the clauses of the
+// others only at its next restart.
+int deterministic(Worker* worker) {
+	EpochState& epoch = *worker->epoch;
+	int res;
+	do {
+		res = ipasir_solve(worker->solver);
+	} while (res == 0 && epoch.first < 0);
+	if (epoch.first < 0) {
+		// finished within this epoch, let the other ones end it as well
+		epoch.result = res;
+		nextEpoch(worker);
+	}
+	return epoch.first == worker->id ? epoch.result : 0;
+}
+
+// Solve cubes until one of them is satisfiable (return 10), the formula
+// is found to be unsatisfiable without any of the split variables (return
+// 20) or there are no more cubes (return 0).  The failed assumptions of
+// an unsatisfiable cube are used to prune other cubes.
+int conquer(Worker* worker) {
+	const vector<int>& split = *worker->split;
+	vector<int> core(split.size());
+	unsigned cube;
+	while (!terminator(NULL) && worker->cubes->next(worker->id, cube)) {
+		if (worker->cubes->refuted(cube)) {
+			continue;
+		}
+		for (size_t j = 0; j < split.size(); j++) {
+			ipasir_assume(worker->solver, (cube >> j) & 1 ? -split[j] : split[j]);
+		}
+		int res = ipasir_solve(worker->solver);
+		if (res == 10) {
+			return 10;
+		}
+		if (res != 20) {
+			continue;
+		}
+		size_t size = ipasir_failed_array(worker->solver, core.empty() ? NULL : &core[0], core.size());
+		unsigned mask = 0, value = 0;
+		for (size_t i = 0; i < size && i < core.size(); i++) {
+			size_t j = find(split.begin(), split.end(), abs(core[i])) - split.begin();
+			mask |= 1u << j;
+			if (core[i] < 0) {
+				value |= 1u << j;
+			}
+		}
+		if (mask == 0) {
+			return 20;
+		}
+		worker->cubes->refute(mask, value);
+	}
+	return 0;
+}
+
+// Add the clauses of the formula to the solver of the given worker.
+// The first solver gets them in the original order, the other ones in
+// a random order to diversify the portfolio.  Shuffling is done on the
+// clause indices, the formula itself is not touched.
+void addFormula(Worker* worker) {
+	const Formula& fla = *worker->formula;
+	if (worker->id == 0) {
+		if (!fla.literals.empty()) {
+			ipasir_add_clauses(worker->solver, &fla.literals[0], fla.literals.size());
+		}
+		return;
+	}
+	vector<size_t> order(fla.starts.size());
+	for (size_t i = 0; i < order.size(); i++) {
+		order[i] = i;
+	}
+	unsigned int seed = 2015 + worker->id;
+	for (size_t i = order.size(); i > 1; i--) {
+		swap(order[i-1], order[rand_r(&seed) % i]);
+	}
+	for (size_t i = 0; i < order.size(); i++) {
+		const int* cls = &fla.literals[fla.starts[order[i]]];
+		size_t size = 0;
+		while (cls[size] != 0) {
+			size++;
+		}
+		ipasir_add_clause(worker->solver, cls, size);
+	}
+}
+
+// Give each solver a different configuration.  The first solver keeps
+// the default one, the other ones get their own seed and cycle through
+// a few variations of restarts, phases and decay.  Options unknown to
+// the linked solver are ignored.
+void diversify(void* solver, int id) {
+	if (id == 0) {
+		return;
+	}
+	ipasir_set_option(solver, "seed", id);
+	switch (id % 4) {
+	case 1:
+		ipasir_set_option(solver, "phase", 1);
+		ipasir_set_option(solver, "rnd_init_act", 1);
+		break;
+	case 2:
+		ipasir_set_option(solver, "luby", 0);
+		ipasir_set_option(solver, "var_decay", 0.9);
+		break;
+	case 3:
+		ipasir_set_option(solver, "phase_saving", 1);
+		ipasir_set_option(solver, "rnd_freq", 0.01);
+		ipasir_set_option(solver, "var_decay", 0.99);
+		break;
+	default:
+		ipasir_set_option(solver, "phase", 0);
+		ipasir_set_option(solver, "rnd_init_act", 1);
+		ipasir_set_option(solver, "rnd_freq", 0.02);
+		ipasir_set_option(solver, "restart_first", 50);
+		break;
+	}
+}
+
+// Each thread is running this function which initializes its solver,
+// loads the formula and runs ipasir_solve
+void* solverThread(void* arg) {
+	Worker* worker = (Worker*)arg;
+	void* solver = worker->solver = ipasir_init();
+	diversify(solver, worker->id);
+	if (worker->epoch != NULL) {
+		// the epochs end in the terminate callback after a number of conflicts
+		ipasir_set_option(solver, "term_period", 1);
+		ipasir_set_terminate(solver, worker, epochTerminator);
+		ipasir_set_learn(solver, worker->epoch, EXCHANGE_MAX_LENGTH, collector);
+		ipasir_set_import(solver, worker->epoch, epochImporter);
+	} else {
+		// set temination callback
+		ipasir_set_terminate(solver, NULL, terminator);
+		// set clause sharing callbacks
+		worker->sharing.id = worker->id;
+		ipasir_set_learn(solver, &worker->sharing, EXCHANGE_MAX_LENGTH, exporter);
+		ipasir_set_import(solver, &worker->sharing, importer);
+	}
+	addFormula(worker);
+	int res;
+	if (worker->epoch != NULL) {
+		res = deterministic(worker);
+	} else if (worker->cubes != NULL) {
+		res = conquer(worker);
+	} else {
+		res = ipasir_solve(solver);
+	}
+	printf("c [genipafolio] solver stopped, res = %d\n", res);
+	done.lock();
+	if (res != 0 && winner < 0) {
+		winner = worker->id;
+		__atomic_store_n(&result, res, __ATOMIC_RELAXED);
+	}
+	stopped++;
+	done.signal();
+	done.unlock();
+	return NULL;
 }
 
 int main(int argc, char** argv) {
 
-	puts("c [genipafolio] USAGE: ./pfolio dimacs.cnf [#threads=4]");
+	puts("c [genipafolio] USAGE: ./pfolio dimacs.cnf [#threads=4] [pinning=1] [#split-variables=0] [#epoch-conflicts=0]");
+	puts("c [genipafolio] pinning: 0 = none, 1 = one thread per physical core, 2 = use hyper-threads as well");
+	puts("c [genipafolio] with split variables the threads solve cubes instead of racing");
+	puts("c [genipafolio] with epoch conflicts the threads race deterministically in epochs");
 
-	srand(2015);
 	char* filename = argv[1];
 	int cores = 4;
 	if (argc > 2) {
 		cores = atoi(argv[2]);
 	}
+	int pinning = 1;
+	if (argc > 3) {
+		pinning = atoi(argv[3]);
+	}
+	vector<int> cpus;
+	if (pinning > 0) {
+		cpus = cpuPlacement(pinning > 1);
+	}
+	int splitting = 0;
+	if (argc > 4) {
+		splitting = min(max(atoi(argv[4]), 0), 20);
+	}
+	if (argc > 5 && splitting == 0) {
+		epochConflicts = max(atoi(argv[5]), 0);
+	}
 
-	void** solvers = (void**)malloc(cores*sizeof(void*));
+	Worker* workers = (Worker*)calloc(cores, sizeof(Worker));
 	Thread** threads = (Thread**)malloc(cores*sizeof(Thread*));
+	exchange.init();
 
-	printf("c [genipafolio] Solving %s with %d cores using %s and shuffling.\n", filename, cores, ipasir_signature());
+	printf("c [genipafolio] Solving %s with %d cores using %s, shuffling and clause sharing.\n", filename, cores, ipasir_signature());
 
-	vector<vector<int> > fla;
+	Formula fla;
 	loadFormula(fla, filename);
 
+	EpochState* epochs = NULL;
+	if (epochConflicts > 0) {
+		epochs = new EpochState[cores];
+		epochBarrier = new Barrier(cores);
+		printf("c [genipafolio] Deterministic mode with epochs of %d conflicts.\n", epochConflicts);
+	}
+
+	vector<int> split;
+	CubeQueue* cubes = NULL;
+	if (splitting > 0) {
+		split = splitVariables(fla, splitting);
+		cubes = new CubeQueue(cores, split.size());
+		printf("c [genipafolio] Cube-and-conquer on %lu variables, %u cubes.\n", split.size(), 1u << split.size());
+	}
+
 	for (int i = 0; i < cores; i++) {
-		// initialize the solver
-		solvers[i] = ipasir_init();
-		// set temination callback
-		ipasir_set_terminate(solvers[i], NULL, terminator);
-		// add the clauses (might be shuffled)
-		for (size_t j = 0; j < fla.size(); j++) {
-			vector<int>& cls = fla[j];
-			for (size_t k = 0; k < cls.size(); k++) {
-				ipasir_add(solvers[i], cls[k]);
-			}
-			ipasir_add(solvers[i], 0);
+		workers[i].id = i;
+		workers[i].formula = &fla;
+		workers[i].cubes = cubes;
+		workers[i].split = &split;
+		workers[i].all = workers;
+		workers[i].count = cores;
+		workers[i].epoch = epochs ? &epochs[i] : NULL;
+		// the solver is created by the thread itself, i.e., after pinning,
+		// such that its memory is allocated on the node of that cpu
+		int cpu = cpus.empty() ? -1 : cpus[i % cpus.size()];
+		threads[i] = new Thread(solverThread, &workers[i], cpu);
+	}
+	// report the result as soon as the first solver has it, the other
+	// ones stop at their next call of the terminator
+	done.lock();
+	while (winner < 0 && stopped < cores) {
+		done.wait();
+	}
+	int first = winner;
+	done.unlock();
+	if (first >= 0) {
+		printf("c [genipafolio] solver %d finished first, result = %d\n", first, result);
+		fflush(stdout);
+		// when racing, do not wait for the slowest solver to notice that it
+		// should stop, its result is not needed and exiting releases it
+		if (cubes == NULL && epochs == NULL) {
+			printf("c [genipafolio] All done, result = %d\n", result);
+			fflush(stdout);
+			_exit(result);
 		}
-		// start the solver
-		threads[i] = new Thread(solverThread, solvers[i]);
-		// shuffle the clauses for the next solver
-		random_shuffle(fla.begin(), fla.end(), randGen);
 	}
-	// wait for each solver to stop and release them
+	// cubes and epochs need all the solvers to stop, wait and release them
 	for (int i = 0; i < cores; i++) {
 		threads[i]->join();
-		ipasir_release(solvers[i]);
+		ipasir_release(workers[i].solver);
+	}
+	// if no cube is satisfiable, the formula is not either
+	if (cubes != NULL && result == 0) {
+		result = 20;
 	}
-	free(solvers);
+	delete cubes;
+	delete[] epochs;
+	delete epochBarrier;
+	free(workers);
 	free(threads);
 	printf("c [genipafolio] All done, result = %d\n", result);
 	return result;
@@ -0,0 +1 @@
+../genipafolio/ClauseExchange.h
\ No newline at end of file
@@ -0,0 +1,287 @@
+/*
+ * genipafork.cpp
+ *
+ * A portfolio SAT solver running each solver in its own process.
+ * The result and the learned clauses are exchanged through a POSIX
+ * shared memory segment.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <vector>
+#include <algorithm>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include "ClauseExchange.h"
+
+// The linked SAT solver might be written in C
+// while this application is written in C++
+extern "C" {
+#include "ipasir.h"
+}
+
+using namespace std;
+
+// Everything the processes share, placed into shared memory by the parent
+// before forking.  All the fields are only accessed atomically.
+struct Shared {
+	int result;
+	int winner;
+	// number of executed workers and how many of them mapped the segment
+	int expected;
+	int attached;
+	ClauseExchange exchange;
+};
+
+Shared* shared = NULL;
+
+// Parse a dimacs cnf formula from a given file and save its clauses into
+// one flat array, each of them terminated by a zero.
+bool loadFormula(vector<int>& literals, vector<size_t>& starts, const char* filename) {
+	FILE* f = fopen(filename, "r");
+	if (f == NULL) {
+		return false;
+	}
+	int c = 0;
+	bool neg = false;
+	size_t start = 0;
+	while (c != EOF) {
+		c = fgetc(f);
+		// comment or problem definition line
+		if (c == 'c' || c == 'p') {
+			// skip this line
+			while(c != '\n' && c != EOF) {
+				c = fgetc(f);
+			}
+			continue;
+		}
+		// whitespace
+		if (isspace(c)) {
+			continue;
+		}
+		// negative
+		if (c == '-') {
+			neg = true;
+			continue;
+		}
+		// number
+		if (isdigit(c)) {
+			int num = c - '0';
+			c = fgetc(f);
+			while (isdigit(c)) {
+				num = num*10 + (c-'0');
+				c = fgetc(f);
+			}
+			if (neg) {
+				num *= -1;
+			}
+			neg = false;
+			literals.push_back(num);
+			if (num == 0) {
+				starts.push_back(start);
+				start = literals.size();
+			}
+		}
+	}
+	fclose(f);
+	return true;
+}
+
+int terminator(void* state) {
+	return __atomic_load_n(&shared->result, __ATOMIC_RELAXED);
+}
+
+// Each solver has its own read position in the exchange and a buffer
+// for the clause which it currently imports.
+struct SharingState {
+	int id;
+	uint64_t cursor;
+	int clause[EXCHANGE_MAX_LENGTH + 1];
+};
+
+void exporter(void* state, int* clause) {
+	shared->exchange.publish(((SharingState*)state)->id, clause);
+}
+
+const int* importer(void* state) {
+	SharingState* s = (SharingState*)state;
+	return shared->exchange.consume(s->id, s->cursor, s->clause) ? s->clause : NULL;
+}
+
+// Load the formula into a new solver and solve it.  Except for the first
+// one the solvers get their own seed, initial phase and clause order.
+// Return the exit code of the worker process.
+int worker(int id, const char* filename) {
+	vector<int> literals;
+	vector<size_t> starts;
+	if (!loadFormula(literals, starts, filename)) {
+		printf("c [genipafork] worker %d could not load %s\n", id, filename);
+		return 1;
+	}
+	void* solver = ipasir_init();
+	if (id > 0) {
+		ipasir_set_option(solver, "seed", id);
+		ipasir_set_option(solver, "phase", id % 2);
+	}
+	ipasir_set_terminate(solver, NULL, terminator);
+	SharingState sharing;
+	memset(&sharing, 0, sizeof(sharing));
+	sharing.id = id;
+	ipasir_set_learn(solver, &sharing, EXCHANGE_MAX_LENGTH, exporter);
+	ipasir_set_import(solver, &sharing, importer);
+
+	vector<size_t> order(starts.size());
+	for (size_t i = 0; i < order.size(); i++) {
+		order[i] = i;
+	}
+	unsigned int seed = 2015 + id;
+	for (size_t i = order.size(); id > 0 && i > 1; i--) {
+		swap(order[i-1], order[rand_r(&seed) % i]);
+	}
+	for (size_t i = 0; i < order.size(); i++) {
+		const int* cls = &literals[starts[order[i]]];
+		size_t size = 0;
+		while (cls[size] != 0) {
+			size++;
+		}
+		ipasir_add_clause(solver, cls, size);
+	}
+
+	int res = ipasir_solve(solver);
+	printf("c [genipafork] worker %d (%s) stopped, res = %d\n", id, ipasir_signature(), res);
+	int none = 0;
+	if (res != 0 && __atomic_compare_exchange_n(&shared->result, &none, res,
+			false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+		__atomic_store_n(&shared->winner, id, __ATOMIC_RELAXED);
+	}
+	ipasir_release(solver);
+	return 0;
+}
+
+// The name of the shared memory segment, removed by a signal handler if
+// the parent is interrupted before all the workers have mapped it.
+char shmName[64];
+
+void removeShared(int sig) {
+	shm_unlink(shmName);
+	signal(sig, SIG_DFL);
+	raise(sig);
+}
+
+// Map the shared memory segment with the given name.
+Shared* mapShared(const char* name, bool create) {
+	int fd = shm_open(name, create ? O_CREAT | O_EXCL | O_RDWR : O_RDWR, 0600);
+	if (fd < 0) {
+		return NULL;
+	}
+	if (create && ftruncate(fd, sizeof(Shared)) != 0) {
+		close(fd);
+		return NULL;
+	}
+	void* res = mmap(NULL, sizeof(Shared), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	return res == MAP_FAILED ? NULL : (Shared*)res;
+}
+
+int main(int argc, char** argv) {
+
+	// a worker started by another genipafork binary:
+	// genipafork -worker <shared-memory-name> <id> <dimacs.cnf>
+	if (argc == 5 && strcmp(argv[1], "-worker") == 0) {
+		shared = mapShared(argv[2], false);
+		if (shared == NULL) {
+			printf("c [genipafork] could not map shared memory %s\n", argv[2]);
+			return 1;
+		}
+		// the last worker to map the segment removes its name, the
+		// mappings stay valid and nothing is left behind in /dev/shm
+		if (__atomic_add_fetch(&shared->attached, 1, __ATOMIC_RELAXED) == shared->expected) {
+			shm_unlink(argv[2]);
+		}
+		return worker(atoi(argv[3]), argv[4]);
+	}
+
+	puts("c [genipafork] USAGE: ./genipafork dimacs.cnf [#processes=4] [genipafork-binary ...]");
+
+	if (argc < 2) {
+		return 0;
+	}
+	char* filename = argv[1];
+	int processes = 4;
+	if (argc > 2) {
+		processes = atoi(argv[2]);
+	}
+	// the given binaries (linked against other solvers) are used in turns,
+	// without binaries all the processes use the solver linked here
+	int binaries = argc > 3 ? argc - 3 : 0;
+
+	snprintf(shmName, sizeof(shmName), "/genipafork-%d", (int)getpid());
+	shared = mapShared(shmName, true);
+	if (shared == NULL) {
+		printf("c [genipafork] could not create shared memory %s\n", shmName);
+		return 1;
+	}
+	shared->exchange.init();
+	shared->result = 0;
+	shared->winner = -1;
+	shared->expected = binaries > 0 ? processes : 0;
+	shared->attached = 0;
+	if (binaries == 0) {
+		// forked workers inherit the mapping, the name is not needed
+		shm_unlink(shmName);
+	} else {
+		signal(SIGINT, removeShared);
+		signal(SIGTERM, removeShared);
+	}
+
+	printf("c [genipafork] Solving %s with %d processes.\n", filename, processes);
+	fflush(stdout);
+
+	vector<pid_t> children;
+	for (int i = 0; i < processes; i++) {
+		pid_t pid = fork();
+		if (pid == 0) {
+			if (binaries == 0) {
+				exit(worker(i, filename));
+			}
+			char id[16];
+			snprintf(id, sizeof(id), "%d", i);
+			const char* binary = argv[3 + i % binaries];
+			execl(binary, binary, "-worker", shmName, id, filename, (char*)NULL);
+			printf("c [genipafork] could not execute %s\n", binary);
+			exit(1);
+		}
+		if (pid > 0) {
+			children.push_back(pid);
+		}
+	}
+
+	// As soon as one process has the result the other ones stop at their
+	// next call of the terminator.
+	size_t running = children.size();
+	while (running > 0 && wait(NULL) > 0) {
+		running--;
+		if (__atomic_load_n(&shared->result, __ATOMIC_RELAXED) != 0) {
+			break;
+		}
+	}
+	int result = __atomic_load_n(&shared->result, __ATOMIC_RELAXED);
+	if (result != 0) {
+		printf("c [genipafork] worker %d finished first, result = %d\n",
+			__atomic_load_n(&shared->winner, __ATOMIC_RELAXED), result);
+		fflush(stdout);
+	}
+	while (running > 0 && wait(NULL) > 0) {
+		running--;
+	}
+	munmap(shared, sizeof(Shared));
+	// only still there if some worker could not be executed
+	shm_unlink(shmName);
+	printf("c [genipafork] All done, result = %d\n", result);
+	return result;
+}
@@ -132,10 +132,8 @@ Graph loadGraph(const char* filename, bool backEdges = false) {
 
 void addFormula(void* solver, const SimpleFormula& formula) {
 	for (size_t i = 0; i < formula.clauses.size(); i++) {
-		for (size_t j = 0; j < formula.clauses[i].size(); j++) {
-			ipasir_add(solver, formula.clauses[i][j]);
-		}
-		ipasir_add(solver, 0);
+		const vector<int>& cls = formula.clauses[i];
+		ipasir_add_clause(solver, cls.empty() ? NULL : &cls[0], cls.size());
 	}
 }
 
@@ -111,10 +111,7 @@ public:
 protected:
 	void* solver;
 	void addClauseIntern(const vector<int>& clause) {
-		for (size_t i = 0; i < clause.size(); i++) {
-			ipasir_add(solver, clause[i]);
-		}
-		ipasir_add(solver, 0);
+		ipasir_add_clause(solver, clause.empty() ? NULL : &clause[0], clause.size());
 	}
 };
 
@@ -142,9 +139,13 @@ int main(int argc, char **argv) {
 	// literals of all soft clauses.
 	int unsatisfiedSoft = 0;
 	vector<WeightedLit> lits;
+	vector<int> values(endActVar - startActVar);
+	if (!values.empty()) {
+		ipasir_val_array(solver, startActVar, values.size(), &values[0]);
+	}
 	for (int i = startActVar; i < endActVar; i++) {
 		lits.push_back(WeightedLit(i,1));
-		if (ipasir_val(solver, i) > 0) {
+		if (values[i - startActVar] > 0) {
 			unsatisfiedSoft++;
 		}
 	}
@@ -170,8 +171,11 @@ int main(int argc, char **argv) {
 	while (res != 20) {
 		// count the unsat soft clauses in the last solution
 		unsatisfiedSoft = 0;
-		for (int i = startActVar; i < endActVar; i++) {
-			if (ipasir_val(solver, i) > 0) {
+		if (!values.empty()) {
+			ipasir_val_array(solver, startActVar, values.size(), &values[0]);
+		}
+		for (size_t i = 0; i < values.size(); i++) {
+			if (values[i] > 0) {
 				unsatisfiedSoft++;
 			}
 		}
@@ -118,23 +118,27 @@ bool loadReachabilityProblem(const char* filename, Formula* initial, Formula* un
 	return true;
 }
 
+// Shift the clauses by the given offset into one zero terminated buffer
+// and pass it to the solver with a single call.
 void addClauses(void* solver, const vector<vector<int> >& clauses, int variableOffset) {
+	static vector<int> buffer;
+	buffer.clear();
 	for (size_t cid = 0; cid < clauses.size(); cid++) {
 		if (clauses[cid].size() > 0) {
 			for (size_t lid = 0; lid < clauses[cid].size(); lid++) {
 				int lit = clauses[cid][lid];
 				if (lit > 0) {
-					ipasir_add(solver, lit+variableOffset);
-					//printf("added %d\n", lit+variableOffset);
+					buffer.push_back(lit+variableOffset);
 				} else {
-					ipasir_add(solver, lit-variableOffset);
-					//printf("added %d\n", lit-variableOffset);
+					buffer.push_back(lit-variableOffset);
 				}
 			}
-			ipasir_add(solver, 0);
-			//printf("added %d\n", 0);
+			buffer.push_back(0);
 		}
 	}
+	if (!buffer.empty()) {
+		ipasir_add_clauses(solver, &buffer[0], buffer.size());
+	}
 }
 
 void assumeLits(void* solver, const vector<int>& lits, int variableOffset) {
@@ -145,13 +145,17 @@ int main (int argc, char ** argv) {
   if (res == 10) {
     printf ("s SATISFIABLE\n");
     if (vars) {
+      int32_t * values = malloc (vars * sizeof *values);
+      if (!values) die ("out of memory");
+      ipasir_val_array (solver, 1, vars, values);
       fflush (stdout);
       fputc ('v', stdout);
       for (i = 1; i <= vars; i++) {
 	if (!(i % 8)) fputs ("\nv", stdout);
-	printf (" %d", ipasir_val (solver, i));
+	printf (" %d", values[i - 1]);
       }
       if (vars) fputc ('\n', stdout);
+      free (values);
     }
     printf ("v 0\n");
   } else if (res == 20) printf ("s UNSATISFIABLE\n");
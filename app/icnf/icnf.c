@@ -97,6 +97,10 @@ int main (int argc, char ** argv) {
   char * sig;
   double pre_time, post_time;
   int * current_assumptions = NULL;
+  int32_t * model = NULL;
+  int model_size = 0;
+  int32_t * core = NULL;
+  size_t core_capacity = 0;
 
   for (i = 1; i < argc; i++) {
     if (!strcmp (argv[i], "-h")) usage ();
@@ -199,29 +203,38 @@ int main (int argc, char ** argv) {
       if (res == 10)
       {
         if (max_var) {
+          if (max_var > model_size)
+            model = realloc (model, sizeof (int32_t) * (model_size = max_var));
+          if (!model) die ("out of memory");
+          ipasir_val_array (solver, 1, max_var, model);
           fflush (stdout);
           printf ("s SATISFIABLE\n");
           fputc ('v', stdout);
           for (i = 1; i <= max_var; i++) {
           if (!(i % 8)) fputs ("\nv", stdout);
-            printf (" %d", ipasir_val (solver, i));
+            printf (" %d", model[i - 1]);
           }
           fputc ('\n', stdout);
         }
         printf ("v 0\n");
       } else if (res == 20) {
         core_size = 0;
+        if (parsed_assumptions > core_capacity)
+          core = realloc (core, sizeof (int32_t) * (core_capacity = parsed_assumptions));
+        if (parsed_assumptions && !core) die ("out of memory");
+        if (parsed_assumptions)
+          core_size = ipasir_failed_array (solver, core, core_capacity);
+        /* the solver may report more failed literals than assumed */
+        if (core_size > core_capacity) {
+          core = realloc (core, sizeof (int32_t) * (core_capacity = core_size));
+          if (!core) die ("out of memory");
+          core_size = ipasir_failed_array (solver, core, core_capacity);
+        }
         fflush (stdout);
         printf ("s UNSATISFIABLE\n");
         fputc ('v', stdout);
-        for( i=0; i < parsed_assumptions; ++i )
-        {
-          if (ipasir_failed(solver, current_assumptions[i] < 0 ? -current_assumptions[i] : current_assumptions[i]))
-          {
-            core_size ++;
-            printf (" %d", current_assumptions[i]);
-          }
-        }
+        for( i=0; i < core_size; ++i )
+          printf (" %d", core[i]);
         fputc ('\n', stdout);
         printf ("v 0\n");
       }
@@ -232,6 +245,8 @@ int main (int argc, char ** argv) {
 
   if (!feof (file)) perr ("end of file is not reached yet");
   if (current_assumptions) free(current_assumptions);
+  if (model) free (model);
+  if (core) free (core);
   if (closefile == 2) pclose (file);
   if (closefile == 1) fclose (file);
 
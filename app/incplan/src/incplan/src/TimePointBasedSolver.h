@@ -60,6 +60,10 @@ public:
 		return solver->solve();
 	}
 
+	std::map<std::string, int64_t> solverStats() {
+		return solver->stats();
+	}
+
 	/**
 	 * This method provides a hint on the literal to be set or zero if no hint is available
 	 * The result is stored in the provided, referenc variables.
@@ -412,6 +412,7 @@ class Solver : public TimePointBasedSolver {
 					TIMED_SCOPE(blkScope, "solve");
 					result = solveSAT();
 				}
+				(*solves.rbegin())["solver"] = solverStats();
 
 				if (options.cleanLitearl) {
 					VLOG(1) << "Cleaning helper Literal.";
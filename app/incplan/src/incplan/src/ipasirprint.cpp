@@ -33,6 +33,12 @@ extern "C" {
 		}
 	}
 
+	void ipasir_add_clauses (void * solver, const int * lits, size_t n){
+		for (size_t i = 0; i < n; i++) {
+			ipasir_add(solver, lits[i]);
+		}
+	}
+
 	void ipasir_assume (void * solver, int lit){
 		UNUSED(solver);
 		std::cout << "a" << lit << " ";
@@ -58,6 +64,11 @@ extern "C" {
 		}
 	}
 
+	int ipasir_solve_async (void * solver, void * data, void (*done)(void * data, int result)){
+		done(data, ipasir_solve(solver));
+		return 1;
+	}
+
 	int ipasir_val (void * solver, int lit){
 		UNUSED(solver);
 		UNUSED(lit);
@@ -84,4 +95,10 @@ extern "C" {
 		UNUSED(learn);
 	}
 
+	void ipasir_stats (void * solver, void * data, void (*stat)(void * data, const char * name, int64_t value)){
+		UNUSED(solver);
+		UNUSED(data);
+		UNUSED(stat);
+	}
+
 }
\ No newline at end of file
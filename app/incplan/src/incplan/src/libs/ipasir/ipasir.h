@@ -4,6 +4,9 @@
 #ifndef ipasir_h_INCLUDED
 #define ipasir_h_INCLUDED
 
+#include <stddef.h>
+#include <stdint.h>
+
 /**
  * Return the name and the version of the incremental SAT
  * solving library.
@@ -47,6 +50,17 @@ void ipasir_release (void * solver);
  */
 void ipasir_add (void * solver, int lit_or_zero);
 
+/**
+ * Add the 'n' literals and zeros in 'lits', which contains a sequence
+ * of zero terminated clauses as in the DIMACS format.  This is
+ * equivalent to calling 'ipasir_add' for each of the 'n' entries in
+ * order, but allows the solver to process the whole buffer in one call.
+ *
+ * Required state: INPUT or SAT or UNSAT
+ * State after: INPUT
+ */
+void ipasir_add_clauses (void * solver, const int * lits, size_t n);
+
 /**
  * Add an assumption for the next SAT search (the next call
  * of ipasir_solve). After calling ipasir_solve all the
@@ -69,6 +83,14 @@ void ipasir_assume (void * solver, int lit);
  */
 int ipasir_solve (void * solver);
 
+/**
+ * Start ipasir_solve on a separate thread and return 1, or 0 if no
+ * thread could be created.  The callback "done" is called from that
+ * thread with "data" and the result of the search once it has finished.
+ * No other function may be called on the solver until then.
+ */
+int ipasir_solve_async (void * solver, void * data, void (*done)(void * data, int result));
+
 /**
  * Get the truth value of the given literal in the found satisfying
  * assignment. Return 'lit' if True, '-lit' if False, and 0 if not important.
@@ -125,6 +147,16 @@ void ipasir_set_terminate (void * solver, void * state, int (*terminate)(void *
  */
 void ipasir_set_learn (void * solver, void * state, int max_length, void (*learn)(void * state, int * clause));
 
+/**
+ * Report the statistics of the solver by calling "stat" once for every
+ * counter with "data", the name of the counter and its current value,
+ * e.g. "conflicts", "decisions" or "time" (microseconds of the last solve).
+ *
+ * Required state: INPUT or SAT or UNSAT
+ * State after: INPUT or SAT or UNSAT
+ */
+void ipasir_stats (void * solver, void * data, void (*stat)(void * data, const char * name, int64_t value));
+
 #ifdef USE_EXTENDED_IPASIR
 	void eipasir_set_select_literal_callback(void *solver, void *state, int (*select_literal)(void *));
 #endif
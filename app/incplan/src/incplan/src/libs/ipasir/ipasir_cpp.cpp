@@ -13,9 +13,19 @@ namespace ipasir {
 		static_cast<Solver*>(state)->learnedClauseCallback(clause);
 	}
 
+	void ipasir_solve_async_callback(void* state, int result) {
+		auto promise = static_cast<std::promise<SolveResult>*>(state);
+		promise->set_value(static_cast<SolveResult>(result));
+		delete promise;
+	}
+
+	void ipasir_stats_callback(void* state, const char* name, int64_t value) {
+		(*static_cast<std::map<std::string, int64_t>*>(state))[name] = value;
+	}
+
 	Solver::Solver():
 		solver(nullptr),
-		terminateCallback([]{return 0;}),
+		terminateCallback(nullptr),
 		selectLiteralCallback([]{return 0;}),
 		learnedClauseCallback([](int*){return;}) {
 
@@ -31,7 +41,14 @@ namespace ipasir {
 	}
 
 	void Solver::add(int lit_or_zero) {
-		ipasir_add(solver, lit_or_zero);
+		pendingLiterals.push_back(lit_or_zero);
+	}
+
+	void Solver::flush() {
+		if (!pendingLiterals.empty()) {
+			ipasir_add_clauses(solver, pendingLiterals.data(), pendingLiterals.size());
+			pendingLiterals.clear();
+		}
 	}
 
 	void Ipasir::addClause(std::vector<int> clause) {
@@ -46,9 +63,25 @@ namespace ipasir {
 	}
 
 	SolveResult Solver::solve() {
+		flush();
 		return static_cast<SolveResult>(ipasir_solve(solver));
 	}
 
+	std::future<SolveResult> Ipasir::solve_async() {
+		return std::async(std::launch::async, [this]{ return this->solve(); });
+	}
+
+	std::future<SolveResult> Solver::solve_async() {
+		flush();
+		auto promise = new std::promise<SolveResult>();
+		auto result = promise->get_future();
+		if (!ipasir_solve_async(solver, promise, &ipasir_solve_async_callback)) {
+			// no thread available, solve right here
+			ipasir_solve_async_callback(promise, ipasir_solve(solver));
+		}
+		return result;
+	}
+
 	int Solver::val(int lit) {
 		return ipasir_val (solver, lit);
 	}
@@ -59,7 +92,13 @@ namespace ipasir {
 
 	void Solver::set_terminate (std::function<int(void)> callback) {
 		terminateCallback = callback;
-		ipasir_set_terminate(this->solver, this, &ipasir_terminate_callback);
+		// do not install a callback which never terminates, the solver
+		// would still have to call it through two indirections
+		if (terminateCallback) {
+			ipasir_set_terminate(this->solver, this, &ipasir_terminate_callback);
+		} else {
+			ipasir_set_terminate(this->solver, nullptr, nullptr);
+		}
 	}
 
 	void Solver::set_learn (int max_length, std::function<void(int*)> callback) {
@@ -67,13 +106,24 @@ namespace ipasir {
 		ipasir_set_learn(this->solver, this, max_length, &ipasir_learn_callback);
 	}
 
+	std::map<std::string, int64_t> Ipasir::stats() {
+		return std::map<std::string, int64_t>();
+	}
+
+	std::map<std::string, int64_t> Solver::stats() {
+		std::map<std::string, int64_t> result;
+		ipasir_stats(solver, &result, &ipasir_stats_callback);
+		return result;
+	}
+
 	void Solver::reset() {
 		if (solver != nullptr) {
 			ipasir_release(solver);
 		}
 		solver = ipasir_init();
+		pendingLiterals.clear();
 
-		set_terminate([]{return 0;});
+		set_terminate(nullptr);
 		set_learn(0,[](int*){return;});
 		#ifdef USE_EXTENDED_IPASIR
 		eipasir_set_select_literal_callback(this->solver, this, &ipasir_select_literal_callback);
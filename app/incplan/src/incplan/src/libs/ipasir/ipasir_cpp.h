@@ -6,6 +6,8 @@ extern "C" {
 
 #include <string>
 #include <functional>
+#include <future>
+#include <map>
 #include <vector>
 
 namespace ipasir {
@@ -64,6 +66,14 @@ public:
 	 */
 	virtual SolveResult solve () = 0;
 
+	/**
+	 * Same as solve, but the search runs on a separate thread and the
+	 * result is delivered through the returned future. No other method
+	 * may be called until the result is available, except that the search
+	 * can be interrupted through the terminate callback.
+	 */
+	virtual std::future<SolveResult> solve_async();
+
 	/**
 	 * Get the truth value of the given literal in the found satisfying
 	 * assignment. Return 'lit' if True, '-lit' if False, and 0 if not important.
@@ -96,6 +106,7 @@ public:
 	 * state of the solver, the state remains unchanged after the call.
 	 * The callback function is of the form "int terminate()"
 	 *   - it returns a non-zero value if the solver should terminate.
+	 * An empty callback (nullptr) removes the callback from the solver.
 	 *
 	 * Required state: INPUT or SAT or UNSAT
 	 * State after: INPUT or SAT or UNSAT
@@ -118,12 +129,24 @@ public:
 	 */
 	virtual void set_learn (int max_length, std::function<void(int*)>) = 0;
 
+	/**
+	 * Return the statistics of the solver as reported by ipasir_stats,
+	 * mapping the name of each counter to its value. Solvers which do
+	 * not provide statistics return an empty map.
+	 *
+	 * Required state: INPUT or SAT or UNSAT
+	 * State after: INPUT or SAT or UNSAT
+	 */
+	virtual std::map<std::string, int64_t> stats();
+
 	virtual void reset() = 0;
 };
 
 extern "C" {
 	int ipasir_terminate_callback(void* state);
 	int ipasir_select_literal_callback(void* state);
+	void ipasir_solve_async_callback(void* state, int result);
+	void ipasir_stats_callback(void* state, const char* name, int64_t value);
 }
 
 class Solver: public Ipasir {
@@ -140,6 +163,8 @@ public:
 
 	virtual SolveResult solve();
 
+	virtual std::future<SolveResult> solve_async();
+
 	virtual int val(int lit);
 
 	virtual int failed (int lit);
@@ -148,14 +173,21 @@ public:
 
 	virtual void set_learn (int max_length, std::function<void(int*)>);
 
+	virtual std::map<std::string, int64_t> stats();
+
 	virtual void reset();
 
 private:
 	void* solver;
+	/* Literals passed to add() are collected here and handed to the
+	 * solver in one ipasir_add_clauses call before the next solve. */
+	std::vector<int> pendingLiterals;
 	std::function<int(void)> terminateCallback;
 	std::function<int(void)> selectLiteralCallback;
 	std::function<void(int*)> learnedClauseCallback;
 
+	void flush();
+
 	friend int ipasir_terminate_callback(void* state);
 	friend int ipasir_select_literal_callback(void* state);
 	friend void ipasir_learn_callback(void* state, int* clause);
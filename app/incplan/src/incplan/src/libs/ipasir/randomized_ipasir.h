@@ -52,6 +52,10 @@ public:
 				std::placeholders::_1));
 	}
 
+	virtual std::map<std::string, int64_t> stats() {
+		return solver->stats();
+	}
+
 	virtual void mappingCallback(int* clause){
 		std::vector<int> mappedClause;
 		for (;*clause != 0; clause++) {
@@ -60,11 +60,10 @@ public:
   /** add clause to formula */
   void addClause(std::vector<int>& lits) {
     for( int i = 0 ; i<lits.size(); ++ i ) {
-      IPASIR( ipasir_add(ipasirSolver, lits[i]); );
       maxVar = lits[i] > maxVar ? lits[i] : maxVar;
       maxVar = -lits[i] > maxVar ? -lits[i] : maxVar;
     }
-    IPASIR( ipasir_add(ipasirSolver, 0); );
+    IPASIR( ipasir_add_clause(ipasirSolver, lits.empty() ? 0 : &lits[0], lits.size()); );
   }
   
   /** initialize learned clause retrival hook */
@@ -93,15 +92,14 @@ public:
     if( SATret == 10 ) {
       model.clear();
       model.resize(maxVar+1);
-      for( int v = 1; v <= maxVar; ++ v ) {
-	IPASIR( model[v] = ipasir_val(ipasirSolver, v); );
-      }
+      IPASIR( if(maxVar) ipasir_val_array(ipasirSolver, 1, maxVar, &model[1]); );
     } else if (SATret == 20) {
       conflict.clear();
-      for( int i=0; i < assumptions.size(); ++i ) {
-	IPASIR( if(ipasir_failed(ipasirSolver,  assumptions[i])) conflict.push_back(-assumptions[i]);
-	        else if(ipasir_failed(ipasirSolver, -assumptions[i])) conflict.push_back(-assumptions[i]); );
-      }
+      conflict.resize(assumptions.size());
+      size_t coreSize = 0;
+      IPASIR( if(!conflict.empty()) coreSize = ipasir_failed_array(ipasirSolver, &conflict[0], conflict.size()); );
+      conflict.resize(coreSize);
+      for( int i=0; i < conflict.size(); ++i ) conflict[i] = -conflict[i];
     } else {
       std::cerr << "ipasir SAT solver terminated with unexpected exit code: " << SATret << ". Abort." << std::endl;
       exit(1);
@@ -4,6 +4,7 @@
 #ifndef ipasir_h_INCLUDED
 #define ipasir_h_INCLUDED
 
+#include <stddef.h>
 #include <stdint.h>
 
 /*
@@ -61,7 +62,9 @@ IPASIR_API const char * ipasir_signature ();
 /**
  * Construct a new solver and return a pointer to it.
  * Use the returned pointer as the first parameter in each
- * of the following functions.
+ * of the following functions.  Solvers do not print anything
+ * by default, the environment variable 'IPASIR_VERBOSITY' gives
+ * the initial value of the option "verbosity" of new solvers.
  *
  * Required state: N/A
  * State after: INPUT
@@ -78,6 +81,47 @@ IPASIR_API void * ipasir_init ();
  */
 IPASIR_API void ipasir_release (void * solver);
 
+/**
+ * Construct a new solver as an independent copy of the given one and
+ * return a pointer to it, or NULL if the solver does not support
+ * copying.  The copy contains all the clauses added so far, including
+ * a partially added clause and pending assumptions, and everything the
+ * solver has learned so far, e.g., learned clauses and the state of
+ * its heuristics.  Callbacks and limits are not copied.  Both solvers
+ * can then be used independently, even in different threads, which
+ * allows for instance to try several extensions of a formula in
+ * parallel without solving it from scratch each time.
+ *
+ * Required state: INPUT or SAT or UNSAT
+ * State after: unchanged, the copy is in state INPUT
+ */
+IPASIR_API void * ipasir_copy (void * solver);
+
+/**
+ * Save the state of the solver to the file with the given name, i.e.,
+ * its clauses, everything it has learned so far and the state of its
+ * heuristics, such that ipasir_load can continue from this point, e.g.,
+ * after the process has been stopped.  A partially added clause,
+ * pending assumptions, callbacks and limits are not saved.  The format
+ * of the file is specific to the solver and the machine.  Return 1 on
+ * success and 0 if the file could not be written or the solver does not
+ * support saving its state.
+ *
+ * Required state: INPUT or SAT or UNSAT
+ * State after: unchanged
+ */
+IPASIR_API int ipasir_save (void * solver, const char * path);
+
+/**
+ * Construct a new solver from a file written by ipasir_save of the
+ * same solver and return a pointer to it, or NULL if the file could not
+ * be read or is not valid.
+ *
+ * Required state: N/A
+ * State after: INPUT
+ */
+IPASIR_API void * ipasir_load (const char * path);
+
 /**
  * Add the given literal into the currently added clause
  * or finalize the clause with a 0.  Clauses added this way
@@ -95,6 +139,56 @@ IPASIR_API void ipasir_release (void * solver);
  */
 IPASIR_API void ipasir_add (void * solver, int32_t lit_or_zero);
 
+/**
+ * Add the clause consisting of the 'n' (non-zero) literals in 'lits'.
+ * This is equivalent to calling 'ipasir_add' for each of the literals
+ * followed by 'ipasir_add (solver, 0)', i.e., if a clause has been
+ * started but not finalized with 'ipasir_add', the literals are added
+ * to that clause.  The solver does not keep a reference to 'lits'.
+ *
+ * Required state: INPUT or SAT or UNSAT
+ * State after: INPUT
+ */
+IPASIR_API void ipasir_add_clause (void * solver, const int32_t * lits, size_t n);
+
+/**
+ * Add the 'n' literals and zeros in 'lits', which contains a sequence
+ * of zero terminated clauses as in the DIMACS format.  This is
+ * equivalent to calling 'ipasir_add' for each of the 'n' entries in
+ * order, but allows the solver to process the whole buffer in one call.
+ * The solver does not keep a reference to 'lits'.
+ *
+ * Required state: INPUT or SAT or UNSAT
+ * State after: INPUT
+ */
+IPASIR_API void ipasir_add_clauses (void * solver, const int32_t * lits, size_t n);
+
+/**
+ * Open a new clause group.  All the clauses added until the group is
+ * closed again with ipasir_pop belong to this group, groups can be
+ * nested.  Return 1 on success and 0 if the solver does not support
+ * clause groups, in which case nothing happened and removable clauses
+ * have to be simulated with activation literals and assumptions.
+ *
+ * Clauses passed to the import callback (see ipasir_set_import) while
+ * groups are open have to be implied by the clauses outside of them.
+ *
+ * Required state: INPUT or SAT or UNSAT
+ * State after: INPUT
+ */
+IPASIR_API int ipasir_push (void * solver);
+
+/**
+ * Close the innermost open clause group and delete all its clauses from
+ * the solver together with the learned clauses derived from them, in
+ * contrast to activation literals, which leave them in the solver.
+ * Return 1 on success and 0 if there is no open group.
+ *
+ * Required state: INPUT or SAT or UNSAT
+ * State after: INPUT
+ */
+IPASIR_API int ipasir_pop (void * solver);
+
 /**
  * Add an assumption for the next SAT search (the next call
  * of ipasir_solve). After calling ipasir_solve all the
@@ -105,6 +199,21 @@ IPASIR_API void ipasir_add (void * solver, int32_t lit_or_zero);
  */
 IPASIR_API void ipasir_assume (void * solver, int32_t lit);
 
+/**
+ * Declare the variable of 'lit' as an interface variable, i.e., a
+ * variable which is going to occur in clauses added or assumptions made
+ * after the next call of ipasir_solve.  This is only a hint: solvers
+ * which eliminate variables between calls keep the declared variables
+ * and the assumed ones, and have to reintroduce any other variable
+ * which occurs again, which is correct but expensive.  The values of
+ * all variables can be queried with ipasir_val regardless of this hint.
+ * A variable stays frozen for the lifetime of the solver.
+ *
+ * Required state: INPUT or SAT or UNSAT
+ * State after: INPUT or SAT or UNSAT
+ */
+IPASIR_API void ipasir_freeze (void * solver, int32_t lit);
+
 /**
  * Solve the formula with specified clauses under the specified
  * assumptions.  If the formula is satisfiable the function returns 10
@@ -121,6 +230,29 @@ IPASIR_API void ipasir_assume (void * solver, int32_t lit);
  */
 IPASIR_API int ipasir_solve (void * solver);
 
+/**
+ * Start solving the formula like ipasir_solve, but on a separate thread,
+ * and return immediately.  Return 1 if the search has been started and
+ * 0 if no thread could be created, in which case nothing happened.  When
+ * the search has finished the solver calls the callback function of the
+ * form "void done(void * data, int result)" from that thread
+ *   - with the parameter "data" having the value passed in the
+ *     ipasir_solve_async function (2nd parameter).
+ *   - with the argument "result" being the return value of ipasir_solve.
+ * Until then no function other than ipasir_signature may be called on
+ * the solver, but the search can be interrupted through the terminate
+ * callback (see ipasir_set_terminate) as usual.  The callbacks of the
+ * solver are called from the separate thread as well.  Afterwards the
+ * solver is in the state ipasir_solve would have left it.
+ *
+ * This function is implemented on top of ipasir_solve and thus not part
+ * of the 'ipasir_interface' table below.
+ *
+ * Required state: INPUT or SAT or UNSAT
+ * State after: SOLVING, then INPUT or SAT or UNSAT before calling 'done'
+ */
+IPASIR_API int ipasir_solve_async (void * solver, void * data, void (*done)(void * data, int result));
+
 /**
  * Get the truth value of the given literal in the found satisfying
  * assignment.  Return 'lit' if True, '-lit' if False; 'ipasir_val(lit)'
@@ -137,6 +269,20 @@ IPASIR_API int ipasir_solve (void * solver);
  */
 IPASIR_API int32_t ipasir_val (void * solver, int32_t lit);
 
+/**
+ * Get the truth values of the 'n' consecutive variables starting with
+ * variable 'first' in the found satisfying assignment.  After the call
+ * 'values[i]' is the same as 'ipasir_val (solver, first + i)' for all
+ * 0 <= i < n, i.e., 'first + i' if True, '-(first + i)' if False and
+ * '0' if the value is not important.  Entries for 'first + i < 1',
+ * which are not variables, are '0' as well.  The caller has to provide a
+ * buffer 'values' with space for at least 'n' entries.
+ *
+ * Required state: SAT
+ * State after: SAT
+ */
+IPASIR_API void ipasir_val_array (void * solver, int32_t first, size_t n, int32_t * values);
+
 /**
  * Check if the given assumption literal was used to prove the
  * unsatisfiability of the formula under the assumptions
@@ -156,6 +302,38 @@ IPASIR_API int32_t ipasir_val (void * solver, int32_t lit);
  */
 IPASIR_API int ipasir_failed (void * solver, int32_t lit);
 
+/**
+ * Get all the assumption literals which were used to prove the
+ * unsatisfiability of the formula under the assumptions used for the
+ * last SAT search, i.e., exactly the assumption literals for which
+ * 'ipasir_failed' returns 1, in no particular order.  At most 'n' of
+ * them are stored in 'core' and the total number of failed assumption
+ * literals is returned.  Thus calling the function with 'n' equal to 0
+ * (and 'core' possibly NULL) returns the size of the core, which can
+ * be used to allocate a large enough buffer for a second call.
+ *
+ * Required state: UNSAT
+ * State after: UNSAT
+ */
+IPASIR_API size_t ipasir_failed_array (void * solver, int32_t * core, size_t n);
+
+/**
+ * Set the solver option 'name' to 'value'.  The available options, their
+ * names and their meaning depend on the solver, but solvers should use the
+ * name "seed" for the seed of the random number generator, "phase" for
+ * the initial phase of decision variables (0 for false and 1 for true) and
+ * "verbosity" for the amount of messages and statistics printed to stdout
+ * (0 for none, which is the default).
+ * Return a non-zero value if the solver knows the option and zero
+ * otherwise, in which case the call has no effect.  Options should be
+ * set before adding clauses, since some of them only affect variables
+ * added afterwards.
+ *
+ * Required state: INPUT or SAT or UNSAT
+ * State after: INPUT or SAT or UNSAT
+ */
+IPASIR_API int ipasir_set_option (void * solver, const char * name, double value);
+
 /**
  * Set a callback function used to indicate a termination requirement to
  * the solver.  The solver will periodically call this function and
@@ -168,11 +346,34 @@ IPASIR_API int ipasir_failed (void * solver, int32_t lit);
  *     having the value passed in the ipasir_set_terminate function
  *     (2nd parameter).
  *
+ * The solver may call the function only every couple of conflicts, so
+ * it can take a moment until the search is actually interrupted.
+ * Setting the callback function to NULL disables the callback.
+ *
  * Required state: INPUT or SAT or UNSAT
  * State after: INPUT or SAT or UNSAT
  */
 IPASIR_API void ipasir_set_terminate (void * solver, void * data, int (*terminate)(void * data));
 
+/**
+ * Set resource limits for the next SAT search (the next call of
+ * ipasir_solve).  The search is interrupted, i.e., ipasir_solve returns
+ * 0, as soon as it has spent more than 'conflicts' conflicts, more than
+ * 'propagations' propagations or more than 'milliseconds' milliseconds
+ * of wall-clock time.  A negative value means no limit.  Like the
+ * assumptions, the limits are cleared after calling ipasir_solve.
+ *
+ * The limits are checked at the same points of the search as the
+ * terminate callback, so they are not exact.  A solver may not
+ * support all of them, for instance a solver without a notion of
+ * propagations may ignore that limit, or approximate conflicts
+ * by decisions.
+ *
+ * Required state: INPUT or SAT or UNSAT
+ * State after: INPUT or SAT or UNSAT
+ */
+IPASIR_API void ipasir_set_limits (void * solver, int64_t conflicts, int64_t propagations, int64_t milliseconds);
+
 /**
  * Set a callback function used to extract learned clauses up to a given
  * length from the solver.  The solver will call this function for each
@@ -200,6 +401,103 @@ IPASIR_API void ipasir_set_terminate (void * solver, void * data, int (*terminat
  */
 IPASIR_API void ipasir_set_learn (void * solver, void * data, int max_length, void (*learn)(void * data, int32_t * clause));
 
+/**
+ * Set a callback function used to import clauses into the solver, e.g.,
+ * clauses learned by other solvers working on the same formula.  The
+ * solver will call this function at points of the search where adding
+ * clauses is cheap and safe, e.g., at restarts, until it returns NULL.
+ * The ipasir_set_import function can be called in any state of the
+ * solver, the state remains unchanged after the call.  The callback
+ * function is of the form "const int * import(void * data)"
+ *   - it returns a pointer to a zero terminated integer array containing
+ *     the next clause to import, or NULL if there are no more clauses
+ *     at this point.  The array has to stay valid until the next call.
+ *   - the solver calls the callback function with the parameter "data"
+ *     having the value passed in the ipasir_set_import function
+ *     (2nd parameter).
+ *   - the solver calls the callback function from the same thread
+ *     in which ipasir_solve has been called.
+ *
+ * The imported clauses have to be implied by the clauses added so far,
+ * since the solver may treat them like its own learned clauses and
+ * delete them again later.  The solver may also ignore clauses, for
+ * instance clauses over variables it does not know yet.
+ *
+ * Subsequent calls to ipasir_set_import override the previously set
+ * callback function.  Setting the callback function to NULL disables
+ * the callback.
+ *
+ * Required state: INPUT or SAT or UNSAT
+ * State after: INPUT or SAT or UNSAT
+ */
+IPASIR_API void ipasir_set_import (void * solver, void * data, const int32_t * (*import)(void * data));
+
+/**
+ * Report the statistics of the solver without printing them by calling
+ * 'stat' for each counter with its name and value.  The first argument
+ * of 'stat' is the 'data' passed to ipasir_stats.  Solvers report those
+ * of the following counters they keep track of and possibly others:
+ *
+ *   "calls"         number of calls of ipasir_solve
+ *   "conflicts"     conflicts in all calls of ipasir_solve
+ *   "decisions"     decisions in all calls of ipasir_solve
+ *   "propagations"  propagated literals in all calls of ipasir_solve
+ *   "restarts"      restarts in all calls of ipasir_solve
+ *   "learnts"       learned clauses currently kept by the solver
+ *   "bytes"         memory currently allocated for clauses in bytes
+ *   "time"          CPU time of the last call of ipasir_solve in
+ *                   microseconds
+ *
+ * Counters over all calls have to be subtracted from their previous
+ * values to get the work done by a single call.
+ *
+ * Required state: INPUT or SAT or UNSAT
+ * State after: INPUT or SAT or UNSAT
+ */
+IPASIR_API void ipasir_stats (void * solver, void * data, void (*stat)(void * data, const char * name, int64_t value));
+
+/**
+ * All the functions above collected in one table, which allows to use
+ * several solvers in one process, e.g., for a portfolio of different
+ * solvers, or to select one at run time.  Every solver back end provides
+ * its table under the name 'ipasir_interface_<IPASIRSOLVER>', e.g.,
+ *
+ *   extern const ipasir_interface ipasir_interface_picosat961;
+ *   void * solver = ipasir_interface_picosat961.init ();
+ *
+ * The global ipasir_* functions just forward to this table but are
+ * defined in a separate object file, so several back end libraries can
+ * be linked into the same application as long as it only uses their
+ * tables.  A solver returned by the 'init' function of one table may
+ * only be passed to the functions of the same table.
+ */
+typedef struct ipasir_interface {
+    const char * (*signature) ();
+    void * (*init) ();
+    void (*release) (void * solver);
+    void * (*copy) (void * solver);
+    int (*save) (void * solver, const char * path);
+    void * (*load) (const char * path);
+    void (*add) (void * solver, int32_t lit_or_zero);
+    void (*add_clause) (void * solver, const int32_t * lits, size_t n);
+    void (*add_clauses) (void * solver, const int32_t * lits, size_t n);
+    int (*push) (void * solver);
+    int (*pop) (void * solver);
+    void (*assume) (void * solver, int32_t lit);
+    void (*freeze) (void * solver, int32_t lit);
+    int (*solve) (void * solver);
+    int32_t (*val) (void * solver, int32_t lit);
+    void (*val_array) (void * solver, int32_t first, size_t n, int32_t * values);
+    int (*failed) (void * solver, int32_t lit);
+    size_t (*failed_array) (void * solver, int32_t * core, size_t n);
+    int (*set_option) (void * solver, const char * name, double value);
+    void (*set_terminate) (void * solver, void * data, int (*terminate)(void * data));
+    void (*set_limits) (void * solver, int64_t conflicts, int64_t propagations, int64_t milliseconds);
+    void (*set_learn) (void * solver, void * data, int max_length, void (*learn)(void * data, int32_t * clause));
+    void (*set_import) (void * solver, void * data, const int32_t * (*import)(void * data));
+    void (*stats) (void * solver, void * data, void (*stat)(void * data, const char * name, int64_t value));
+} ipasir_interface;
+
 #ifdef __cplusplus
 } // closing extern "C"
 #endif
@@ -0,0 +1,87 @@
+/* The global ipasir_* functions of a solver back end, which forward to
+ * its 'ipasir_interface' table.  The name of the table is given by
+ * defining IPASIR_INTERFACE while compiling this file, e.g.,
+ *
+ *   gcc -DIPASIR_INTERFACE=ipasir_interface_picosat961 -c ipasirglobal.c
+ *
+ * This is kept separate from the glue code defining the table, so that
+ * the glue code of several back ends can be linked together.
+ */
+#include "ipasir.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+
+extern const ipasir_interface IPASIR_INTERFACE;
+
+const char * ipasir_signature () { return IPASIR_INTERFACE.signature (); }
+void * ipasir_init () { return IPASIR_INTERFACE.init (); }
+void ipasir_release (void * s) { IPASIR_INTERFACE.release (s); }
+void * ipasir_copy (void * s) { return IPASIR_INTERFACE.copy (s); }
+int ipasir_save (void * s, const char * path) { return IPASIR_INTERFACE.save (s, path); }
+void * ipasir_load (const char * path) { return IPASIR_INTERFACE.load (path); }
+void ipasir_add (void * s, int32_t l) { IPASIR_INTERFACE.add (s, l); }
+void ipasir_add_clause (void * s, const int32_t * l, size_t n) { IPASIR_INTERFACE.add_clause (s, l, n); }
+void ipasir_add_clauses (void * s, const int32_t * l, size_t n) { IPASIR_INTERFACE.add_clauses (s, l, n); }
+int ipasir_push (void * s) { return IPASIR_INTERFACE.push (s); }
+int ipasir_pop (void * s) { return IPASIR_INTERFACE.pop (s); }
+void ipasir_assume (void * s, int32_t l) { IPASIR_INTERFACE.assume (s, l); }
+void ipasir_freeze (void * s, int32_t l) { IPASIR_INTERFACE.freeze (s, l); }
+int ipasir_solve (void * s) { return IPASIR_INTERFACE.solve (s); }
+int32_t ipasir_val (void * s, int32_t l) { return IPASIR_INTERFACE.val (s, l); }
+void ipasir_val_array (void * s, int32_t f, size_t n, int32_t * v) { IPASIR_INTERFACE.val_array (s, f, n, v); }
+int ipasir_failed (void * s, int32_t l) { return IPASIR_INTERFACE.failed (s, l); }
+size_t ipasir_failed_array (void * s, int32_t * c, size_t n) { return IPASIR_INTERFACE.failed_array (s, c, n); }
+int ipasir_set_option (void * s, const char * n, double v) { return IPASIR_INTERFACE.set_option (s, n, v); }
+
+void ipasir_set_terminate (void * s, void * data, int (*terminate)(void * data)) {
+  IPASIR_INTERFACE.set_terminate (s, data, terminate);
+}
+
+void ipasir_set_limits (void * s, int64_t c, int64_t p, int64_t ms) {
+  IPASIR_INTERFACE.set_limits (s, c, p, ms);
+}
+
+void ipasir_set_learn (void * s, void * data, int max_length, void (*learn)(void * data, int32_t * clause)) {
+  IPASIR_INTERFACE.set_learn (s, data, max_length, learn);
+}
+
+void ipasir_set_import (void * s, void * data, const int32_t * (*import)(void * data)) {
+  IPASIR_INTERFACE.set_import (s, data, import);
+}
+
+void ipasir_stats (void * s, void * data, void (*stat)(void * data, const char * name, int64_t value)) {
+  IPASIR_INTERFACE.stats (s, data, stat);
+}
+
+/* An asynchronous search is just a call of 'solve' on a detached thread.
+ */
+typedef struct ipasir_async_call {
+  void * solver;
+  void * data;
+  void (*done) (void * data, int result);
+} ipasir_async_call;
+
+static void * ipasir_async_solve (void * arg) {
+  ipasir_async_call call = * (ipasir_async_call *) arg;
+  free (arg);
+  call.done (call.data, IPASIR_INTERFACE.solve (call.solver));
+  return 0;
+}
+
+int ipasir_solve_async (void * s, void * data, void (*done)(void * data, int result)) {
+  ipasir_async_call * call = malloc (sizeof *call);
+  pthread_attr_t attr;
+  pthread_t thread;
+  int res;
+  if (!call) return 0;
+  call->solver = s;
+  call->data = data;
+  call->done = done;
+  pthread_attr_init (&attr);
+  pthread_attr_setdetachstate (&attr, PTHREAD_CREATE_DETACHED);
+  res = pthread_create (&thread, &attr, ipasir_async_solve, call);
+  pthread_attr_destroy (&attr);
+  if (res) free (call);
+  return !res;
+}
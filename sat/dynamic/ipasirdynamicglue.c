@@ -0,0 +1,125 @@
+/* Glue code which loads the actual solver at run time from the shared
+ * library given in the environment variable 'IPASIR_LIBRARY', e.g.,
+ *
+ *   IPASIR_LIBRARY=sat/minisat220/ipasirminisat220.so bin/genipasat-dynamic f.cnf
+ *
+ * and forwards all calls to it.  The solver pointers are the ones of the
+ * loaded library.
+ */
+#include "ipasir.h"
+
+#include <dlfcn.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* The table of the loaded solver, resolved from its global functions.
+ */
+static ipasir_interface lib;
+
+static pthread_once_t loaded = PTHREAD_ONCE_INIT;
+
+static void die (const char * msg, const char * arg) {
+  fprintf (stderr, "*** ipasir dynamic: %s%s\n", msg, arg);
+  exit (1);
+}
+
+static void * resolve (void * handle, const char * name) {
+  void * res = dlsym (handle, name);
+  if (!res) die ("missing symbol ", name);
+  return res;
+}
+
+#define RESOLVE(NAME) \
+  *(void **) (&lib.NAME) = resolve (handle, "ipasir_" #NAME)
+
+static void load_library (void) {
+  const char * path = getenv ("IPASIR_LIBRARY");
+  void * handle;
+  if (!path) die ("environment variable IPASIR_LIBRARY not set", "");
+  handle = dlopen (path, RTLD_NOW | RTLD_LOCAL);
+  if (!handle) die ("could not load ", dlerror ());
+  RESOLVE (signature);
+  RESOLVE (init);
+  RESOLVE (release);
+  RESOLVE (copy);
+  RESOLVE (save);
+  RESOLVE (load);
+  RESOLVE (add);
+  RESOLVE (add_clause);
+  RESOLVE (add_clauses);
+  RESOLVE (push);
+  RESOLVE (pop);
+  RESOLVE (assume);
+  RESOLVE (freeze);
+  RESOLVE (solve);
+  RESOLVE (val);
+  RESOLVE (val_array);
+  RESOLVE (failed);
+  RESOLVE (failed_array);
+  RESOLVE (set_terminate);
+  RESOLVE (set_limits);
+  RESOLVE (set_option);
+  RESOLVE (set_learn);
+  RESOLVE (set_import);
+  RESOLVE (stats);
+}
+
+static const char * signature () {
+  pthread_once (&loaded, load_library);
+  return lib.signature ();
+}
+
+static void * init () {
+  pthread_once (&loaded, load_library);
+  return lib.init ();
+}
+
+static void release (void * s) { lib.release (s); }
+static void * copy (void * s) { return lib.copy (s); }
+static int save (void * s, const char * path) { return lib.save (s, path); }
+
+static void * load (const char * path) {
+  pthread_once (&loaded, load_library);
+  return lib.load (path);
+}
+static void add (void * s, int32_t l) { lib.add (s, l); }
+static void add_clause (void * s, const int32_t * l, size_t n) { lib.add_clause (s, l, n); }
+static void add_clauses (void * s, const int32_t * l, size_t n) { lib.add_clauses (s, l, n); }
+static int push (void * s) { return lib.push (s); }
+static int pop (void * s) { return lib.pop (s); }
+static void assume (void * s, int32_t l) { lib.assume (s, l); }
+static void freeze (void * s, int32_t l) { lib.freeze (s, l); }
+static int solve (void * s) { return lib.solve (s); }
+static int32_t val (void * s, int32_t l) { return lib.val (s, l); }
+static void val_array (void * s, int32_t f, size_t n, int32_t * v) { lib.val_array (s, f, n, v); }
+static int failed (void * s, int32_t l) { return lib.failed (s, l); }
+static size_t failed_array (void * s, int32_t * c, size_t n) { return lib.failed_array (s, c, n); }
+static int set_option (void * s, const char * n, double v) { return lib.set_option (s, n, v); }
+
+static void set_terminate (void * s, void * state, int (*terminate) (void * state)) {
+  lib.set_terminate (s, state, terminate);
+}
+
+static void set_limits (void * s, int64_t c, int64_t p, int64_t ms) {
+  lib.set_limits (s, c, p, ms);
+}
+
+static void set_learn (void * s, void * state, int max_length, void (*learn) (void * state, int32_t * clause)) {
+  lib.set_learn (s, state, max_length, learn);
+}
+
+static void set_import (void * s, void * state, const int32_t * (*import) (void * state)) {
+  lib.set_import (s, state, import);
+}
+
+static void stats (void * s, void * data, void (*stat) (void * data, const char * name, int64_t value)) {
+  lib.stats (s, data, stat);
+}
+
+const ipasir_interface IPASIR_INTERFACE = {
+  signature, init, release, copy, save, load, add, add_clause,
+  add_clauses, push, pop, assume, freeze, solve, val, val_array,
+  failed, failed_array, set_option, set_terminate, set_limits,
+  set_learn, set_import, stats
+};
@@ -0,0 +1 @@
+../../ipasirglobal.c
\ No newline at end of file
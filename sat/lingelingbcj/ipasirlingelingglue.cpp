@@ -8,50 +8,358 @@
 
 #include "ipasir.h"
 
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <time.h>
+
 extern "C" {
 	#include "lingeling-bcj/lglib.h"
 }
 
-const char* ipasir_signature() {
+static double wallclock() {
+	struct timespec t;
+	if (clock_gettime(CLOCK_MONOTONIC, &t)) {
+		return 0;
+	}
+	return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+// CPU time of the calling thread, which is the one running lglsat
+static double threadtime() {
+	struct timespec t;
+	if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t)) {
+		return 0;
+	}
+	return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+/**
+ * Lingeling does not remember the assumptions after a call to lglsat,
+ * so we keep them here to be able to report the failed ones at once.
+ * The terminate callback of the user is wrapped to also check the
+ * deadline set by ipasir_set_limits.  Only the variables declared with
+ * ipasir_freeze and the assumed ones are frozen, all the others may be
+ * eliminated by lingeling, which reconstructs their values in lglderef.
+ * Learned clauses are exported through the clause and unit producers of
+ * lingeling, which are also used by plingeling for sharing clauses.
+ */
+struct IPAsirLingeling {
+	LGL* lgl;
+	std::vector<int32_t> assumptions;
+	std::vector<bool> frozen;
+	bool solved;
+	int64_t conflicts, propagations, milliseconds;
+	double deadline;
+	void* state;
+	int (*terminate)(void* state);
+	void* learnState;
+	int maxLength;
+	void (*learn)(void* state, int32_t* clause);
+	std::vector<int32_t> learned;
+	int64_t calls, time;
+
+	IPAsirLingeling(LGL* lgl):lgl(lgl),solved(false),
+		conflicts(-1),propagations(-1),milliseconds(-1),deadline(0),
+		state(NULL),terminate(NULL),learnState(NULL),maxLength(0),
+		learn(NULL),calls(0),time(0) {
+	}
+	~IPAsirLingeling() {
+		lglrelease(lgl);
+	}
+};
+
+static IPAsirLingeling* import(void* solver) {
+	return (IPAsirLingeling*)solver;
+}
+
+static int terminateWrapper(void* solver) {
+	IPAsirLingeling* s = import(solver);
+	if (s->terminate != NULL && s->terminate(s->state)) {
+		return 1;
+	}
+	return s->deadline && wallclock() >= s->deadline;
+}
+
+static void updateTerminate(IPAsirLingeling* s) {
+	if (s->terminate != NULL || s->deadline) {
+		lglseterm(s->lgl, terminateWrapper, s);
+	} else {
+		lglseterm(s->lgl, NULL, NULL);
+	}
+}
+
+// the empty clause and clauses longer than the limit are not exported
+static void exportClause(IPAsirLingeling* s, const int* clause) {
+	if (!*clause) {
+		return;
+	}
+	s->learned.clear();
+	for (const int* p = clause; *p; p++) {
+		if ((int)s->learned.size() == s->maxLength) {
+			return;
+		}
+		s->learned.push_back(*p);
+	}
+	s->learned.push_back(0);
+	s->learn(s->learnState, &s->learned[0]);
+}
+
+static void produceUnit(void* solver, int lit) {
+	int clause[2] = { lit, 0 };
+	exportClause(import(solver), clause);
+}
+
+static void produceClause(void* solver, int* clause, int glue) {
+	exportClause(import(solver), clause);
+}
+
+static void updateLearn(IPAsirLingeling* s) {
+	if (s->learn != NULL) {
+		lglsetproduceunit(s->lgl, produceUnit, s);
+		lglsetproducecls(s->lgl, produceClause, s);
+	} else {
+		lglsetproduceunit(s->lgl, NULL, NULL);
+		lglsetproducecls(s->lgl, NULL, NULL);
+	}
+}
+
+static void setLimit(LGL* lgl, const char* name, int64_t limit) {
+	if (lglhasopt(lgl, name)) {
+		lglsetopt(lgl, name, limit < INT_MAX ? (int)limit : INT_MAX);
+	}
+}
+
+static const char* signature() {
 	return lglversion();
 }
 
-void* ipasir_init() {
-	return lglinit();
+// solvers are silent unless IPASIR_VERBOSITY is set
+static void* init() {
+	LGL* lgl = lglinit();
+	const char* env = getenv("IPASIR_VERBOSITY");
+	if (env) {
+		lglsetopt(lgl, "verbose", atoi(env));
+	}
+	return new IPAsirLingeling(lgl);
+}
+
+static void* copy(void* solver) {
+	IPAsirLingeling* s = import(solver);
+	IPAsirLingeling* res = new IPAsirLingeling(lglclone(s->lgl));
+	res->assumptions = s->assumptions;
+	res->frozen = s->frozen;
+	res->solved = s->solved;
+	// do not let the clone call the callbacks of the original
+	updateTerminate(res);
+	updateLearn(res);
+	return res;
+}
+
+// lingeling can not save its state
+static int save(void* solver, const char* path) {
+	return 0;
+}
+
+static void* load(const char* path) {
+	return NULL;
+}
+
+// clause groups are not supported
+static int push(void* solver) {
+	return 0;
 }
 
-void ipasir_release(void* solver) {
-	lglrelease((LGL*)solver);
+static int pop(void* solver) {
+	return 0;
 }
 
-void ipasir_add(void* solver, int32_t lit) {
+static void release(void* solver) {
+	delete import(solver);
+}
+
+// a variable which is not frozen may have been eliminated by an earlier
+// call of lglsat, in which case it has to be reintroduced to be used again
+static void reuse(LGL* lgl, int32_t lit) {
+	if (!lglusable(lgl, lit)) {
+		lglreuse(lgl, lit);
+	}
+}
+
+static void addLit(LGL* lgl, int32_t lit) {
 	if (lit != 0) {
-		lglfreeze((LGL*)solver, lit);
+		reuse(lgl, lit);
+	}
+	lgladd(lgl, lit);
+}
+
+static void add(void* solver, int32_t lit) {
+	addLit(import(solver)->lgl, lit);
+}
+
+static void add_clause(void* solver, const int32_t* lits, size_t n) {
+	LGL* lgl = import(solver)->lgl;
+	for (size_t i = 0; i < n; i++) {
+		addLit(lgl, lits[i]);
+	}
+	lgladd(lgl, 0);
+}
+
+static void add_clauses(void* solver, const int32_t* lits, size_t n) {
+	LGL* lgl = import(solver)->lgl;
+	for (size_t i = 0; i < n; i++) {
+		addLit(lgl, lits[i]);
+	}
+}
+
+// lingeling counts the calls of lglfreeze, so every variable is frozen once
+static void freeze(void* solver, int32_t lit) {
+	IPAsirLingeling* s = import(solver);
+	size_t var = std::abs(lit);
+	if (var >= s->frozen.size()) {
+		s->frozen.resize(var + 1, false);
+	}
+	if (!s->frozen[var]) {
+		reuse(s->lgl, lit);
+		lglfreeze(s->lgl, lit);
+		s->frozen[var] = true;
+	}
+}
+
+static void assume(void* solver, int32_t lit) {
+	IPAsirLingeling* s = import(solver);
+	if (s->solved) {
+		s->assumptions.clear();
+		s->solved = false;
+	}
+	s->assumptions.push_back(lit);
+	freeze(solver, lit);
+	lglassume(s->lgl, lit);
+}
+
+static int solve(void* solver) {
+	IPAsirLingeling* s = import(solver);
+	double start = threadtime();
+	if (s->solved) {
+		s->assumptions.clear();
+	}
+	s->solved = true;
+	s->calls++;
+	// the limits of lingeling are relative to the current call
+	// and the propagation limit is given in thousands
+	if (s->conflicts >= 0) {
+		setLimit(s->lgl, "clim", s->conflicts);
+	}
+	if (s->propagations >= 0) {
+		setLimit(s->lgl, "plim", (s->propagations + 999) / 1000);
+	}
+	if (s->milliseconds >= 0) {
+		s->deadline = wallclock() + 1e-3 * s->milliseconds;
+		updateTerminate(s);
+	}
+	int res = lglsat(s->lgl);
+	if (s->conflicts >= 0) {
+		setLimit(s->lgl, "clim", -1);
 	}
-	lgladd((LGL*)solver, lit);
+	if (s->propagations >= 0) {
+		setLimit(s->lgl, "plim", -1);
+	}
+	if (s->milliseconds >= 0) {
+		s->deadline = 0;
+		updateTerminate(s);
+	}
+	s->conflicts = s->propagations = s->milliseconds = -1;
+	s->time = (int64_t)(1e6 * (threadtime() - start));
+	return res;
 }
 
-void ipasir_assume(void* solver, int32_t lit) {
-	lglfreeze((LGL*)solver, lit);
-	lglassume((LGL*)solver, lit);
+static void set_limits(void* solver, int64_t conflicts, int64_t propagations, int64_t milliseconds) {
+	IPAsirLingeling* s = import(solver);
+	s->conflicts = conflicts;
+	s->propagations = propagations;
+	s->milliseconds = milliseconds;
 }
 
-int ipasir_solve(void* solver) {
-	return lglsat((LGL*)solver);
+// all the options of lingeling can be set by their names,
+// "verbosity" is an alias for "verbose"
+static int set_option(void* solver, const char* name, double value) {
+	LGL* lgl = import(solver)->lgl;
+	if (!strcmp(name, "verbosity")) {
+		name = "verbose";
+	}
+	if (!lglhasopt(lgl, name)) {
+		return 0;
+	}
+	lglsetopt(lgl, name, (int)value);
+	return 1;
 }
 
-int ipasir_val(void * solver, int32_t var) {
-	return var*lglderef((LGL*)solver, var);
+static int val(void * solver, int32_t var) {
+	return var*lglderef(import(solver)->lgl, var);
 }
 
-int ipasir_failed(void * solver, int32_t lit) {
-	return lglfailed((LGL*)solver, lit);
+static void val_array(void * solver, int32_t first, size_t n, int32_t * values) {
+	LGL* lgl = import(solver)->lgl;
+	for (size_t i = 0; i < n; i++) {
+		int32_t var = first + (int32_t)i;
+		values[i] = (var < 1) ? 0 : var*lglderef(lgl, var);
+	}
 }
 
-void ipasir_set_terminate(void * solver,  void * state, int (*terminate)(void * state)) {
-	lglseterm((LGL*)solver, terminate, state);
+static int failed(void * solver, int32_t lit) {
+	return lglfailed(import(solver)->lgl, lit);
 }
 
-void ipasir_set_learn (void * solver, void * state, int max_length, void (*learn)(void * state, int32_t * clause)) {
+static size_t failed_array(void * solver, int32_t * core, size_t n) {
+	IPAsirLingeling* s = import(solver);
+	size_t res = 0;
+	for (size_t i = 0; i < s->assumptions.size(); i++) {
+		int32_t lit = s->assumptions[i];
+		if (lglfailed(s->lgl, lit)) {
+			if (res < n) {
+				core[res] = lit;
+			}
+			res++;
+		}
+	}
+	return res;
+}
+
+static void set_terminate(void * solver,  void * state, int (*terminate)(void * state)) {
+	IPAsirLingeling* s = import(solver);
+	s->state = state;
+	s->terminate = terminate;
+	updateTerminate(s);
+}
+
+static void set_learn(void * solver, void * state, int max_length, void (*learn)(void * state, int32_t * clause)) {
+	IPAsirLingeling* s = import(solver);
+	s->learnState = state;
+	s->maxLength = max_length;
+	s->learn = learn;
+	updateLearn(s);
+}
+
+static void set_import(void * solver, void * state, const int32_t * (*import)(void * state)) {
 	//not implemented
 }
+
+// lingeling does not provide the number of restarts and learned clauses
+// and the number of bytes covers all of its memory, not only clauses
+static void stats(void * solver, void * data, void (*stat)(void * data, const char * name, int64_t value)) {
+	IPAsirLingeling* s = import(solver);
+	stat(data, "calls", s->calls);
+	stat(data, "conflicts", lglgetconfs(s->lgl));
+	stat(data, "decisions", lglgetdecs(s->lgl));
+	stat(data, "propagations", lglgetprops(s->lgl));
+	stat(data, "bytes", lglbytes(s->lgl));
+	stat(data, "time", s->time);
+}
+
+extern "C" const ipasir_interface IPASIR_INTERFACE = {
+	signature, init, release, copy, save, load, add, add_clause,
+	add_clauses, push, pop, assume, freeze, solve, val, val_array,
+	failed, failed_array, set_option, set_terminate, set_limits,
+	set_learn, set_import, stats
+};
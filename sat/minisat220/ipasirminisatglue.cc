@@ -6,21 +6,64 @@
  */
 #define __STDC_LIMIT_MACROS
 #define __STDC_FORMAT_MACROS
+// With IPASIR_MINISAT_SIMP defined the glue is built on top of 'SimpSolver'
+// for the 'minisatsimp220' back end, which eliminates variables between
+// the calls of 'solve'.
+#ifdef IPASIR_MINISAT_SIMP
+#include "SimpSolver.h"
+#else
 #include "Solver.h"
+#endif
 
 #include <cassert>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <climits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 using namespace std;
 using namespace Minisat;
 
+#ifdef IPASIR_MINISAT_SIMP
+typedef SimpSolver IPAsirMiniSATBase;
+#else
+typedef Solver IPAsirMiniSATBase;
+#endif
+
+// Number of conflicts between two calls of the terminate callback.
+#ifndef IPASIR_TERM_PERIOD
+#define IPASIR_TERM_PERIOD 16
+#endif
+
 extern "C" {
+#ifdef IPASIR_MINISAT_SIMP
+static const char * sig = "minisatsimp" VERSION;
+#else
 static const char * sig = "minisat" VERSION;
+#endif
 #include <sys/resource.h>
 #include <sys/time.h>
+#include <time.h>
+static double wallclock (void) {
+  struct timespec t;
+  if (clock_gettime (CLOCK_MONOTONIC, &t)) return 0;
+  return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+// Solvers are silent unless 'IPASIR_VERBOSITY' is set.
+static int getverbosity (void) {
+  const char * env = getenv ("IPASIR_VERBOSITY");
+  return env ? atoi (env) : 0;
+}
+// CPU time of the calling thread, which is the one running 'solve'.
+static double threadtime (void) {
+  struct timespec t;
+  if (clock_gettime (CLOCK_THREAD_CPUTIME_ID, &t)) return 0;
+  return t.tv_sec + 1e-9 * t.tv_nsec;
+}
 static double getime (void) {
   struct rusage u;
   double res;
@@ -31,14 +74,133 @@ static double getime (void) {
 }
 };
 
-class IPAsirMiniSAT : public Solver {
-  vec<Lit> assumptions, clause;
+// Layout of the files written by 'ipasir_save'.  The header is followed
+// by the activities of all variables (double), then 'words' values of
+// type int32_t, i.e., the top-level trail, the solver variables of the
+// 'mapped' ipasir variables and of the selectors of the open 'groups',
+// and the clauses, each as its size followed by its literals, and finally
+// the saved phases and the decision flags of all variables (char).  The
+// clauses start with the original ones and for learnt clauses the size is
+// followed by the activity (float).  Literals are given in terms of the
+// solver variables, i.e., 'v+1' for variable 'v' of the solver.  The file
+// is written in native byte order.
+#define IPASIR_SAVE_MAGIC "MSAT220\n"
+struct IPAsirMiniSATHeader {
+  char magic[8];
+  int32_t vars, trail, qhead, ok, phase, adjust_cnt, mapped, groups;
+  int64_t clauses, learnts, words;
+  double var_inc, cla_inc, max_learnts, adjust_confl, random_seed;
+};
+
+// The class has internal linkage, since the glue code is compiled for
+// both MiniSAT back ends, which may be linked into one application.
+namespace {
+
+class IPAsirMiniSAT : public IPAsirMiniSATBase {
+  vec<Lit> assumptions, clause, solving;
+  // Clause groups are implemented with selector variables, which are added
+  // to all the clauses of a group and assumed to be false while the group is
+  // open.  Since selectors are solver variables as well, ipasir variable 'v'
+  // is solver variable 'vars[v-1]' and 'names' maps solver variables back to
+  // ipasir variables (or zero for selectors).  Closing a group releases its
+  // selector, which satisfies and thus deletes the clauses of the group and
+  // all the learned clauses derived from them.
+  vec<Var> vars, groups;
+  vec<int32_t> names;
+  void * learnState; void (*learnFun) (void *, int32_t *);
+  void * importState; const int32_t * (*importFun) (void *);
+  vec<int32_t> imported;
   int szfmap; unsigned char * fmap; bool nomodel;
-  unsigned long long calls;
+  unsigned long long calls; int64_t lastTime;
+  int64_t conflimit, proplimit, timelimit; double deadline;
+  void * termState; int (*termFun) (void *);
+  static int terminate (void * s) {
+    IPAsirMiniSAT * solver = (IPAsirMiniSAT *) s;
+    if (solver->termFun && solver->termFun (solver->termState)) return 1;
+    return solver->deadline && wallclock () >= solver->deadline;
+  }
+  // Only install the wrapper if there is something to check, since
+  // 'withinBudget' calls the terminate callback very often.
+  void updateTerm () {
+    if (termFun || deadline) setTermCallback (this, terminate);
+    else setTermCallback (0, 0);
+  }
   void reset () { if (fmap) delete [] fmap, fmap = 0, szfmap = 0; }
+  int phase;
+  void name (Var v, int32_t n) {
+    if (names.size () <= v) names.growTo (v + 1, 0);
+    names[v] = n;
+  }
+  void newVars (int32_t maxvar) {
+    while (maxvar > vars.size ()) {
+      Var v = newVar ();
+      if (phase >= 0) polarity[v] = !phase;
+      vars.push (v);
+      name (v, vars.size ());
+    }
+  }
   Lit import (int32_t lit) {
-    while (abs (lit) > nVars ()) (void) newVar ();
-    return mkLit (Var (abs (lit) - 1), (lit < 0));
+    newVars (abs (lit));
+    return mkLit (vars[abs (lit) - 1], (lit < 0));
+  }
+#ifdef IPASIR_MINISAT_SIMP
+  // Variables used in clauses or assumptions after they have been
+  // eliminated are reintroduced together with their clauses.  The assumed
+  // ones, the selectors and the ones declared by 'ipasir_freeze' are
+  // frozen to avoid eliminating them again.
+  Lit reuse (Lit lit) {
+    if (isEliminated (var (lit))) reintroduce (var (lit));
+    return lit;
+  }
+  void freeze (Lit lit) { setFrozen (var (reuse (lit)), true); }
+  bool usable (Var v) const { return !isEliminated (v); }
+#else
+  Lit reuse (Lit lit) { return lit; }
+  void freeze (Lit) { }
+  bool usable (Var) const { return true; }
+#endif
+  int32_t external (Lit lit) const {
+    int32_t res = names[var (lit)];
+    return sign (lit) ? -res : res;
+  }
+  void commit () {
+    if (groups.size ()) clause.push (mkLit (groups.last ()));
+    addClause (clause), clause.clear ();
+  }
+  // Learned clauses containing selectors depend on open groups and are not
+  // exported, all the others are translated to ipasir variables.
+  static void learnWrapper (void * s, int * clause) {
+    IPAsirMiniSAT * solver = (IPAsirMiniSAT *) s;
+    for (int * p = clause; *p; p++) {
+      int32_t res = solver->names[abs (*p) - 1];
+      if (!res) return;
+      *p = (*p < 0) ? -res : res;
+    }
+    solver->learnFun (solver->learnState, clause);
+  }
+  // Imported clauses are translated to solver variables, unknown and
+  // eliminated variables are mapped beyond the last one, which lets
+  // 'importClauses' drop them.
+  static const int * importWrapper (void * s) {
+    IPAsirMiniSAT * solver = (IPAsirMiniSAT *) s;
+    const int32_t * lits = solver->importFun (solver->importState);
+    if (!lits) return 0;
+    vec<int32_t> & res = solver->imported;
+    res.clear ();
+    for (; *lits; lits++) {
+      int32_t idx = abs (*lits), v = solver->nVars () + 1;
+      if (*lits != INT32_MIN && idx <= solver->vars.size () &&
+          solver->usable (solver->vars[idx - 1])) v = solver->vars[idx - 1] + 1;
+      res.push ((*lits < 0) ? -v : v);
+    }
+    res.push (0);
+    return res;
+  }
+  void reserve (const int32_t * lits, size_t n) {
+    int32_t maxvar = 0;
+    for (size_t i = 0; i < n; i++)
+      if (abs (lits[i]) > maxvar) maxvar = abs (lits[i]);
+    newVars (maxvar);
   }
   void ana () {
     fmap = new unsigned char [szfmap = nVars ()];
@@ -50,30 +212,265 @@ class IPAsirMiniSAT : public Solver {
     }
   }
   double ps (double s, double t) { return t ? s/t : 0; }
+  static int32_t exportLit (Lit lit) {
+    return sign (lit) ? -(var (lit) + 1) : (var (lit) + 1);
+  }
+  void writeClauses (FILE * file, const vec<CRef> & cs) {
+    for (int i = 0; i < cs.size (); i++) {
+      Clause & c = ca[cs[i]];
+      int32_t size = c.size ();
+      fwrite (&size, sizeof size, 1, file);
+      if (c.learnt ()) { float act = c.activity (); fwrite (&act, sizeof act, 1, file); }
+      for (int j = 0; j < c.size (); j++) {
+        int32_t lit = exportLit (c[j]);
+        fwrite (&lit, sizeof lit, 1, file);
+      }
+    }
+  }
+  // Read 'n' clauses from 'p' (not beyond 'end'), return false if the
+  // file is corrupted.
+  bool readClauses (const int32_t * & p, const int32_t * end, int64_t n, bool learnt) {
+    vec<Lit> lits;
+    for (int64_t i = 0; i < n; i++) {
+      if (end - p < 1 + learnt) return false;
+      int32_t size = *p++;
+      float act = 0;
+      if (learnt) memcpy (&act, p++, sizeof act);
+      if (size < 2 || end - p < size) return false;
+      lits.clear ();
+      for (int32_t j = 0; j < size; j++, p++) {
+        if (!*p || *p == INT32_MIN || abs (*p) > nVars ()) return false;
+        lits.push (mkLit (Var (abs (*p) - 1), (*p < 0)));
+      }
+      CRef cr = ca.alloc (lits, learnt);
+      if (learnt) ca[cr].activity () = act, learnts.push (cr);
+      else clauses.push (cr);
+      attachClause (cr);
+    }
+    return true;
+  }
 public:
-  IPAsirMiniSAT () : szfmap (0), fmap (0), nomodel (false), calls (0) {
-    // MiniSAT by default produces non standard conforming messages.
-    // So either we have to set this to '0' or patch the sources.
-    verbosity = 1;
+  IPAsirMiniSAT () :
+    learnState (0), learnFun (0), importState (0), importFun (0),
+    szfmap (0), fmap (0), nomodel (false), calls (0), lastTime (0),
+    conflimit (-1), proplimit (-1), timelimit (-1), deadline (0),
+    termState (0), termFun (0), phase (-1)
+  {
+    // MiniSAT by default produces non standard conforming messages,
+    // which are patched in the makefile to start with 'c'.
+    verbosity = getverbosity ();
+    setTermCallbackPeriod (IPASIR_TERM_PERIOD);
   }
   ~IPAsirMiniSAT () { reset (); }
+  IPAsirMiniSAT * copy () const {
+    IPAsirMiniSAT * res = new IPAsirMiniSAT ();
+    copyTo (*res);
+    assumptions.copyTo (res->assumptions);
+    clause.copyTo (res->clause);
+    vars.copyTo (res->vars);
+    groups.copyTo (res->groups);
+    names.copyTo (res->names);
+    res->phase = phase;
+    return res;
+  }
+  // Has to be called between 'solve' calls, i.e., at decision level 0.
+  bool save (const char * path) {
+    assert (decisionLevel () == 0);
+    FILE * file = fopen (path, "wb");
+    if (!file) return false;
+    IPAsirMiniSATHeader h;
+    memset (&h, 0, sizeof h);
+    memcpy (h.magic, IPASIR_SAVE_MAGIC, sizeof h.magic);
+    h.vars = nVars (), h.trail = trail.size (), h.qhead = qhead;
+    h.ok = ok, h.phase = phase, h.adjust_cnt = learntsize_adjust_cnt;
+    h.mapped = vars.size (), h.groups = groups.size ();
+    h.clauses = clauses.size (), h.learnts = learnts.size ();
+    h.var_inc = var_inc, h.cla_inc = cla_inc, h.max_learnts = max_learnts;
+    h.adjust_confl = learntsize_adjust_confl, h.random_seed = random_seed;
+    h.words = h.trail + h.mapped + h.groups + h.clauses + 2*h.learnts;
+    for (int i = 0; i < clauses.size (); i++) h.words += ca[clauses[i]].size ();
+    for (int i = 0; i < learnts.size (); i++) h.words += ca[learnts[i]].size ();
+    fwrite (&h, sizeof h, 1, file);
+    for (Var v = 0; v < nVars (); v++) fwrite (&activity[v], sizeof (double), 1, file);
+    for (int i = 0; i < trail.size (); i++) {
+      int32_t lit = exportLit (trail[i]);
+      fwrite (&lit, sizeof lit, 1, file);
+    }
+    fwrite ((Var *) vars, sizeof (Var), vars.size (), file);
+    fwrite ((Var *) groups, sizeof (Var), groups.size (), file);
+    writeClauses (file, clauses);
+    writeClauses (file, learnts);
+    for (Var v = 0; v < nVars (); v++) fwrite (&polarity[v], 1, 1, file);
+    for (Var v = 0; v < nVars (); v++) fwrite (&decision[v], 1, 1, file);
+    bool res = !ferror (file);
+    return (fclose (file) == 0) && res;
+  }
+  // The file is mapped into memory instead of being read piece by piece.
+  static IPAsirMiniSAT * load (const char * path) {
+    int fd = open (path, O_RDONLY);
+    if (fd < 0) return 0;
+    struct stat st;
+    void * map = MAP_FAILED;
+    if (!fstat (fd, &st) && st.st_size >= (off_t) sizeof (IPAsirMiniSATHeader))
+      map = mmap (0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close (fd);
+    if (map == MAP_FAILED) return 0;
+    IPAsirMiniSAT * res = new IPAsirMiniSAT ();
+    if (!res->restore ((const char *) map, st.st_size)) delete res, res = 0;
+    munmap (map, st.st_size);
+    return res;
+  }
+  bool restore (const char * data, size_t size) {
+    IPAsirMiniSATHeader h;
+    memcpy (&h, data, sizeof h);
+    if (memcmp (h.magic, IPASIR_SAVE_MAGIC, sizeof h.magic)) return false;
+    if (h.vars < 0 || h.trail < 0 || h.trail > h.vars ||
+        h.qhead < 0 || h.qhead > h.trail ||
+        h.mapped < 0 || h.groups < 0 || h.mapped + (int64_t) h.groups > h.vars ||
+        h.clauses < 0 || h.learnts < 0 || h.words < 0) return false;
+    if ((size - sizeof h) / 10 < (size_t) h.vars) return false;
+    size_t bytes = size - sizeof h - 10 * (size_t) h.vars;
+    if (bytes % sizeof (int32_t) || bytes / sizeof (int32_t) != (size_t) h.words)
+      return false;
+    const char * p = data + sizeof h;
+    const int32_t * q = (const int32_t *) (p + h.vars * sizeof (double));
+    const int32_t * end = q + h.words;
+    const char * flags = (const char *) end;
+    while (nVars () < h.vars) newVar ();
+    for (Var v = 0; v < h.vars; v++, p += sizeof (double))
+      memcpy (&activity[v], p, sizeof (double));
+    for (Var v = 0; v < h.vars; v++) polarity[v] = flags[v];
+    for (Var v = 0; v < h.vars; v++) setDecisionVar (v, flags[h.vars + v]);
+    for (int i = 0; i < h.trail; i++, q++) {
+      if (!*q || *q == INT32_MIN || abs (*q) > h.vars) return false;
+      Lit lit = mkLit (Var (abs (*q) - 1), (*q < 0));
+      if (value (lit) != l_Undef) return false;
+      uncheckedEnqueue (lit);
+    }
+    qhead = h.qhead;
+    rebuildOrderHeap ();
+    names.growTo (h.vars, 0);
+    for (int i = 0; i < h.mapped + h.groups; i++, q++) {
+      if (*q < 0 || *q >= h.vars || names[*q]) return false;
+      if (i < h.mapped) vars.push (*q), names[*q] = vars.size ();
+      else groups.push (*q), names[*q] = -1;
+    }
+    for (int i = 0; i < groups.size (); i++) names[groups[i]] = 0;
+    if (!readClauses (q, end, h.clauses, false)) return false;
+    if (!readClauses (q, end, h.learnts, true)) return false;
+    if (q != end) return false;
+    ok = h.ok, phase = h.phase, learntsize_adjust_cnt = h.adjust_cnt;
+    var_inc = h.var_inc, cla_inc = h.cla_inc, max_learnts = h.max_learnts;
+    learntsize_adjust_confl = h.adjust_confl, random_seed = h.random_seed;
+    return true;
+  }
   void add (int32_t lit) {
     reset ();
     nomodel = true;
-    if (lit) clause.push (import (lit));
-    else addClause (clause), clause.clear ();
+    if (lit) clause.push (reuse (import (lit)));
+    else commit ();
+  }
+  void add (const int32_t * lits, size_t n, bool finalize) {
+    reset ();
+    nomodel = true;
+    reserve (lits, n);
+    if (finalize) clause.capacity (clause.size () + n);
+    for (size_t i = 0; i < n; i++) {
+      int32_t lit = lits[i];
+      if (lit) clause.push (reuse (mkLit (vars[abs (lit) - 1], (lit < 0))));
+      else commit ();
+    }
+    if (finalize) commit ();
   }
   void assume (int32_t lit) {
     reset ();
     nomodel = true;
-    assumptions.push (import (lit));
+    Lit res = import (lit);
+    freeze (res);
+    assumptions.push (res);
+  }
+  void freeze (int32_t lit) { reset (); freeze (import (lit)); }
+  void setLearn (void * state, int maxLength, void (*fun)(void *, int32_t *)) {
+    learnState = state, learnFun = fun;
+    if (fun) setLearnCallback (this, maxLength, learnWrapper);
+    else setLearnCallback (0, maxLength, 0);
+  }
+  void setImport (void * state, const int32_t * (*fun)(void *)) {
+    importState = state, importFun = fun;
+    if (fun) setImportCallback (this, importWrapper);
+    else setImportCallback (0, 0);
+  }
+  void push () {
+    reset ();
+    nomodel = true;
+    Var s = newVar (l_Undef, false);
+    name (s, 0);
+    freeze (mkLit (s));
+    groups.push (s);
+  }
+  // Simplification is forced to delete the satisfied clauses right away.
+  bool pop () {
+    if (!groups.size ()) return false;
+    reset ();
+    nomodel = true;
+    releaseVar (mkLit (groups.last ()));
+    groups.pop ();
+    simpDB_props = 0;
+    simplify ();
+    return true;
+  }
+  void setTerm (void * state, int (*fun)(void *)) {
+    termState = state, termFun = fun;
+    updateTerm ();
+  }
+  void limit (int64_t conflicts, int64_t propagations, int64_t milliseconds) {
+    conflimit = conflicts, proplimit = propagations, timelimit = milliseconds;
+  }
+  // Options are named after the corresponding members of 'Solver'.
+  // In addition 'phase' is the initial phase of new variables and
+  // 'term_period' the number of conflicts between terminate checks.
+  // With 'SimpSolver' variable elimination can be disabled with 'elim'.
+  int option (const char * name, double value) {
+    if (!strcmp (name, "seed")) {
+      if (value <= 0) return 0;
+      random_seed = value;
+    } else if (!strcmp (name, "phase")) phase = value != 0;
+    else if (!strcmp (name, "var_decay")) var_decay = value;
+    else if (!strcmp (name, "clause_decay")) clause_decay = value;
+    else if (!strcmp (name, "rnd_freq")) random_var_freq = value;
+    else if (!strcmp (name, "rnd_init_act")) rnd_init_act = value != 0;
+    else if (!strcmp (name, "phase_saving")) phase_saving = (int) value;
+    else if (!strcmp (name, "luby")) luby_restart = value != 0;
+    else if (!strcmp (name, "restart_first")) restart_first = (int) value;
+    else if (!strcmp (name, "restart_inc")) restart_inc = value;
+    else if (!strcmp (name, "verbosity")) verbosity = (int) value;
+    else if (!strcmp (name, "term_period")) setTermCallbackPeriod ((int) value);
+#ifdef IPASIR_MINISAT_SIMP
+    else if (!strcmp (name, "elim")) use_elim = value != 0;
+#endif
+    else return 0;
+    return 1;
   }
   int solve () {
+    double start = threadtime ();
     calls++;
     reset ();
-    lbool res = solveLimited (assumptions);
+    if (conflimit >= 0) setConfBudget (conflimit);
+    if (proplimit >= 0) setPropBudget (proplimit);
+    if (timelimit >= 0) deadline = wallclock () + 1e-3 * timelimit, updateTerm ();
+    lbool res;
+    if (groups.size ()) {
+      solving.clear ();
+      for (int i = 0; i < groups.size (); i++) solving.push (~mkLit (groups[i]));
+      for (int i = 0; i < assumptions.size (); i++) solving.push (assumptions[i]);
+      res = solveLimited (solving);
+    } else res = solveLimited (assumptions);
+    if (conflimit >= 0 || proplimit >= 0) budgetOff ();
+    if (timelimit >= 0) deadline = 0, updateTerm ();
+    conflimit = proplimit = timelimit = -1;
     assumptions.clear ();
     nomodel = (res != l_True);
+    lastTime = (int64_t) (1e6 * (threadtime () - start));
     return (res == l_Undef) ? 0 : (res == l_True ? 10 : 20);
   }
   int val (int32_t lit) {
@@ -81,12 +478,39 @@ public:
     lbool res = modelValue (import (lit));
     return (res == l_True) ? lit : -lit;
   }
+  void val (int32_t first, size_t n, int32_t * values) {
+    for (size_t i = 0; i < n; i++) {
+      int32_t lit = first + (int32_t) i;
+      if (nomodel || lit < 1 || lit > vars.size ()) values[i] = 0;
+      else values[i] = (model[vars[lit - 1]] == l_True) ? lit : -lit;
+    }
+  }
   int failed (int32_t lit) {
     if (!fmap) ana ();
     int tmp = var (import (lit));
     assert (0 <= tmp && tmp < nVars ());
     return fmap[tmp] != 0;
   }
+  size_t failed (int32_t * core, size_t n) {
+    size_t res = 0;
+    for (int i = 0; i < conflict.size (); i++) {
+      int32_t lit = external (~conflict[i]);
+      if (!lit) continue;
+      if (res < n) core[res] = lit;
+      res++;
+    }
+    return res;
+  }
+  void stats (void * data, void (*stat) (void *, const char *, int64_t)) {
+    stat (data, "calls", calls);
+    stat (data, "conflicts", conflicts);
+    stat (data, "decisions", decisions);
+    stat (data, "propagations", propagations);
+    stat (data, "restarts", starts);
+    stat (data, "learnts", nLearnts ());
+    stat (data, "bytes", (int64_t) ca.size () * ClauseAllocator::Unit_Size);
+    stat (data, "time", lastTime);
+  }
   void stats () {
     double t = getime ();
     printf (
@@ -108,17 +532,49 @@ public:
   }
 };
 
+}
+
 extern "C" {
 #include "ipasir.h"
 static IPAsirMiniSAT * import (void * s) { return (IPAsirMiniSAT*) s; }
-const char * ipasir_signature () { return sig; }
-void * ipasir_init () { return new IPAsirMiniSAT (); }
-void ipasir_release (void * s) { import (s)->stats (); delete import (s); }
-int ipasir_solve (void * s) { return import (s)->solve (); }
-void ipasir_add (void * s, int32_t l) { import (s)->add (l); }
-void ipasir_assume (void * s, int32_t l) { import (s)->assume (l); }
-int ipasir_val (void * s, int32_t l) { return import (s)->val (l); }
-int ipasir_failed (void * s, int32_t l) { return import (s)->failed (l); }
-void ipasir_set_terminate (void * s, void * state, int (*callback)(void * state)) { import(s)->setTermCallback(state, callback); }
-void ipasir_set_learn (void * s, void * state, int max_length, void (*learn)(void * state, int32_t * clause)) { import(s)->setLearnCallback(state, max_length, learn); }
+static const char * signature () { return sig; }
+static void * init () { return new IPAsirMiniSAT (); }
+static void release (void * s) {
+  if (import (s)->verbosity) import (s)->stats ();
+  delete import (s);
+}
+#ifdef IPASIR_MINISAT_SIMP
+// the state of the variable elimination is neither copied nor saved
+static void * copy (void * s) { return 0; }
+static int save (void * s, const char * path) { return 0; }
+static void * load (const char * path) { return 0; }
+#else
+static void * copy (void * s) { return import (s)->copy (); }
+static int save (void * s, const char * path) { return import (s)->save (path); }
+static void * load (const char * path) { return IPAsirMiniSAT::load (path); }
+#endif
+static int solve (void * s) { return import (s)->solve (); }
+static void add (void * s, int32_t l) { import (s)->add (l); }
+static void add_clause (void * s, const int32_t * l, size_t n) { import (s)->add (l, n, true); }
+static void add_clauses (void * s, const int32_t * l, size_t n) { import (s)->add (l, n, false); }
+static void assume (void * s, int32_t l) { import (s)->assume (l); }
+static void freeze (void * s, int32_t l) { import (s)->freeze (l); }
+static int val (void * s, int32_t l) { return import (s)->val (l); }
+static void val_array (void * s, int32_t f, size_t n, int32_t * v) { import (s)->val (f, n, v); }
+static int failed (void * s, int32_t l) { return import (s)->failed (l); }
+static size_t failed_array (void * s, int32_t * c, size_t n) { return import (s)->failed (c, n); }
+static void set_terminate (void * s, void * state, int (*callback)(void * state)) { import(s)->setTerm(state, callback); }
+static void set_limits (void * s, int64_t c, int64_t p, int64_t ms) { import (s)->limit (c, p, ms); }
+static int set_option (void * s, const char * n, double v) { return import (s)->option (n, v); }
+static void set_learn (void * s, void * state, int max_length, void (*learn)(void * state, int32_t * clause)) { import(s)->setLearn(state, max_length, learn); }
+static void set_import (void * s, void * state, const int32_t * (*callback)(void * state)) { import(s)->setImport(state, callback); }
+static void stats (void * s, void * data, void (*stat)(void * data, const char * name, int64_t value)) { import (s)->stats (data, stat); }
+static int push (void * s) { import (s)->push (); return 1; }
+static int pop (void * s) { return import (s)->pop (); }
+extern const ipasir_interface IPASIR_INTERFACE = {
+  signature, init, release, copy, save, load, add, add_clause,
+  add_clauses, push, pop, assume, freeze, solve, val, val_array,
+  failed, failed_array, set_option, set_terminate, set_limits,
+  set_learn, set_import, stats
+};
 };
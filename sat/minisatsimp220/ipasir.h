@@ -0,0 +1 @@
+../../ipasir.h
\ No newline at end of file
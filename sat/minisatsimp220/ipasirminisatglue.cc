@@ -0,0 +1 @@
+../minisat220/ipasirminisatglue.cc
\ No newline at end of file
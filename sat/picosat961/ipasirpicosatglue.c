@@ -1,48 +1,262 @@
 #include "ipasir.h"
 #include "picosat.h"
 
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
 static const char * sig = "picosat" VERSION;
 
-const char * ipasir_signature () { return sig; }
+/* Picosat only knows about a single interrupt function, which we need
+ * to share between the user's terminate callback and the deadline of
+ * 'ipasir_set_limits'.  Thus the solver handle is wrapped.
+ */
+typedef struct IPAsirPicoSAT {
+  PicoSAT * picosat;
+  int64_t conflicts, propagations, milliseconds;
+  double deadline;
+  void * state;
+  int (*terminate) (void *);
+  int verbosity;
+  int64_t calls, time;
+} IPAsirPicoSAT;
+
+static PicoSAT * import (void * solver) {
+  return ((IPAsirPicoSAT *) solver)->picosat;
+}
+
+static double wallclock (void) {
+  struct timespec t;
+  if (clock_gettime (CLOCK_MONOTONIC, &t)) return 0;
+  return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+/* CPU time of the calling thread, which is the one running 'solve'.
+ */
+static double threadtime (void) {
+  struct timespec t;
+  if (clock_gettime (CLOCK_THREAD_CPUTIME_ID, &t)) return 0;
+  return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+static int interrupt (void * solver) {
+  IPAsirPicoSAT * s = solver;
+  if (s->terminate && s->terminate (s->state)) return 1;
+  return s->deadline && wallclock () >= s->deadline;
+}
+
+static void update_interrupt (IPAsirPicoSAT * s) {
+  if (s->terminate || s->deadline)
+    picosat_set_interrupt (s->picosat, s, interrupt);
+  else picosat_set_interrupt (s->picosat, 0, 0);
+}
+
+static const char * signature () { return sig; }
 
-void * ipasir_init () { 
+/* Solvers are silent unless 'IPASIR_VERBOSITY' is set.
+ */
+static int getverbosity (void) {
+  const char * env = getenv ("IPASIR_VERBOSITY");
+  return env ? atoi (env) : 0;
+}
+
+static void * init () { 
   char prefix[80];
-  void * res = picosat_init ();
+  IPAsirPicoSAT * res = malloc (sizeof *res);
+  if (!res) return 0;
+  res->picosat = picosat_init ();
+  res->conflicts = res->propagations = res->milliseconds = -1;
+  res->deadline = 0;
+  res->state = 0;
+  res->terminate = 0;
+  res->verbosity = getverbosity ();
+  res->calls = res->time = 0;
   sprintf (prefix, "c [%s] ", sig);
-  picosat_set_prefix (res, prefix);
-  picosat_set_verbosity (res, 1);
-  picosat_set_output (res, stdout);
+  picosat_set_prefix (res->picosat, prefix);
+  picosat_set_verbosity (res->picosat, res->verbosity);
+  picosat_set_output (res->picosat, stdout);
   return res;
 }
 
-void ipasir_release (void * solver) {
-  picosat_stats (solver);
-  picosat_reset (solver);
+static void release (void * solver) {
+  IPAsirPicoSAT * s = solver;
+  if (s->verbosity) picosat_stats (s->picosat);
+  picosat_reset (import (solver));
+  free (solver);
 }
 
-void ipasir_add (void * solver, int32_t lit) { picosat_add (solver, lit); }
+/* Picosat can neither copy nor save its state.
+ */
+static void * copy (void * solver) { return 0; }
+static int save (void * solver, const char * path) { return 0; }
+static void * load (const char * path) { return 0; }
+
+/* Picosat has contexts, but their selector variables are taken from the
+ * same range as the user variables, which would require to map all the
+ * variables in this glue code.  So clause groups are not supported.
+ */
+static int push (void * solver) { return 0; }
+static int pop (void * solver) { return 0; }
 
-void ipasir_assume (void * solver, int32_t lit) { picosat_assume (solver, lit); }
+static void add (void * solver, int32_t lit) { picosat_add (import (solver), lit); }
 
-int ipasir_solve (void * solver) { return picosat_sat (solver, -1); }
+/* Allocate all variables of a batch at once instead of growing the
+ * variable table literal by literal in 'picosat_add'.
+ */
+static void reserve (PicoSAT * solver, const int32_t * lits, size_t n) {
+  int32_t maxvar = 0;
+  size_t i;
+  for (i = 0; i < n; i++)
+    if (abs (lits[i]) > maxvar) maxvar = abs (lits[i]);
+  if (maxvar > picosat_variables (solver)) picosat_adjust (solver, maxvar);
+}
+
+static void add_clause (void * s, const int32_t * lits, size_t n) {
+  PicoSAT * solver = import (s);
+  size_t i;
+  reserve (solver, lits, n);
+  for (i = 0; i < n; i++) picosat_add (solver, lits[i]);
+  picosat_add (solver, 0);
+}
+
+static void add_clauses (void * s, const int32_t * lits, size_t n) {
+  PicoSAT * solver = import (s);
+  size_t i;
+  reserve (solver, lits, n);
+  for (i = 0; i < n; i++) picosat_add (solver, lits[i]);
+}
 
-int ipasir_failed (void * solver, int32_t lit) {
-  return picosat_failed_assumption (solver, lit);
+static void assume (void * solver, int32_t lit) {
+  picosat_assume (import (solver), lit);
 }
 
-int ipasir_val (void * solver, int32_t var) {
-  int val = picosat_deref (solver, var);
+/* Picosat does not eliminate variables, so there is nothing to freeze */
+static void freeze (void * solver, int32_t lit) {}
+
+/* Picosat has no conflict limit, so we use its decision limit instead,
+ * which like the conflict limit is relative to the current call.  The
+ * propagation limit on the other hand is absolute.
+ */
+static int solve (void * solver) {
+  IPAsirPicoSAT * s = solver;
+  double start = threadtime ();
+  int decisions = -1, res;
+  s->calls++;
+  if (s->conflicts >= 0)
+    decisions = s->conflicts < INT_MAX ? (int) s->conflicts : INT_MAX;
+  if (s->propagations >= 0)
+    picosat_set_propagation_limit (s->picosat,
+      picosat_propagations (s->picosat) + s->propagations);
+  if (s->milliseconds >= 0) {
+    s->deadline = wallclock () + 1e-3 * s->milliseconds;
+    update_interrupt (s);
+  }
+  res = picosat_sat (s->picosat, decisions);
+  if (s->propagations >= 0)
+    picosat_set_propagation_limit (s->picosat, ~0ull);
+  if (s->milliseconds >= 0) {
+    s->deadline = 0;
+    update_interrupt (s);
+  }
+  s->conflicts = s->propagations = s->milliseconds = -1;
+  s->time = (int64_t) (1e6 * (threadtime () - start));
+  return res;
+}
+
+static void set_limits (void * solver,
+  int64_t conflicts, int64_t propagations, int64_t milliseconds) {
+  IPAsirPicoSAT * s = solver;
+  s->conflicts = conflicts;
+  s->propagations = propagations;
+  s->milliseconds = milliseconds;
+}
+
+/* Besides 'seed' and 'phase' (which also accepts 2 for Jeroslow-Wang
+ * and 3 for random phases) only 'verbosity' is supported.
+ */
+static int set_option (void * solver, const char * name, double value) {
+  PicoSAT * picosat = import (solver);
+  if (!strcmp (name, "seed")) picosat_set_seed (picosat, (unsigned) value);
+  else if (!strcmp (name, "phase")) {
+    if (value < 0 || value > 3) return 0;
+    picosat_set_global_default_phase (picosat, (int) value);
+  } else if (!strcmp (name, "verbosity")) {
+    ((IPAsirPicoSAT *) solver)->verbosity = (int) value;
+    picosat_set_verbosity (picosat, (int) value);
+  }
+  else return 0;
+  return 1;
+}
+
+static int failed (void * solver, int32_t lit) {
+  return picosat_failed_assumption (import (solver), lit);
+}
+
+static size_t failed_array (void * solver, int32_t * core, size_t n) {
+  const int * p = picosat_failed_assumptions (import (solver));
+  size_t res = 0;
+  for (; *p; p++, res++)
+    if (res < n) core[res] = *p;
+  return res;
+}
+
+static int val (void * solver, int32_t var) {
+  int val = picosat_deref (import (solver), var);
   if (!val) return 0;
   return val < 0 ? -var : var;
 }
 
-void
-ipasir_set_terminate (
+static void val_array (void * s, int32_t first, size_t n, int32_t * values) {
+  PicoSAT * solver = import (s);
+  int32_t var = first;
+  size_t i;
+  int val;
+  for (i = 0; i < n; i++, var++) {
+    val = (var < 1) ? 0 : picosat_deref (solver, var);
+    values[i] = val ? (val < 0 ? -var : var) : 0;
+  }
+}
+
+static void
+set_terminate (
   void * solver,
   void * state, int (*terminate)(void * state)) {
-  picosat_set_interrupt (solver, state, terminate);
+  IPAsirPicoSAT * s = solver;
+  s->state = state;
+  s->terminate = terminate;
+  update_interrupt (s);
 }
 
-/* Picosat does not implement clause sharing functionality */
-void ipasir_set_learn (void * solver, void * state, int max_length, void (*learn)(void * state, int32_t * clause)) {}
+/* Learned clauses are exported by 'picosat-c.patch' right where they are
+ * added to the clause database.
+ */
+static void set_learn (void * solver, void * state, int max_length, void (*learn)(void * state, int32_t * clause)) {
+  picosat_set_learn (import (solver), state, max_length, learn);
+}
+
+/* Picosat can not import clauses during the search */
+static void set_import (void * solver, void * state, const int32_t * (*import)(void * state)) {}
+
+/* Only the large learned clauses are counted by picosat and the number of
+ * bytes covers all the memory allocated by picosat, not only for clauses.
+ */
+static void stats (void * solver, void * data, void (*stat)(void * data, const char * name, int64_t value)) {
+  IPAsirPicoSAT * s = solver;
+  stat (data, "calls", s->calls);
+  stat (data, "conflicts", picosat_conflicts (s->picosat));
+  stat (data, "decisions", picosat_decisions (s->picosat));
+  stat (data, "propagations", picosat_propagations (s->picosat));
+  stat (data, "restarts", picosat_restarts (s->picosat));
+  stat (data, "learnts", picosat_learned_clauses (s->picosat));
+  stat (data, "bytes", picosat_bytes_allocated (s->picosat));
+  stat (data, "time", s->time);
+}
 
+const ipasir_interface IPASIR_INTERFACE = {
+  signature, init, release, copy, save, load, add, add_clause,
+  add_clauses, push, pop, assume, freeze, solve, val, val_array,
+  failed, failed_array, set_option, set_terminate, set_limits,
+  set_learn, set_import, stats
+};